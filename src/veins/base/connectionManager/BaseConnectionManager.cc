@@ -24,6 +24,10 @@
 
 #include "veins/base/connectionManager/BaseConnectionManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "veins/base/connectionManager/NicEntryDebug.h"
 #include "veins/base/connectionManager/NicEntryDirect.h"
 #include "veins/base/modules/BaseWorldUtility.h"
@@ -82,6 +86,21 @@ void BaseConnectionManager::initialize(int stage)
         else
             sendDirect = false;
 
+        lazyConnections = hasPar("lazyConnections") ? par("lazyConnections").boolValue() : false;
+        if (lazyConnections && !sendDirect) throw cRuntimeError("lazyConnections requires sendDirect, as there are no gates to connect");
+
+        batchPosUpdates = hasPar("batchPosUpdates") ? par("batchPosUpdates").boolValue() : false;
+        if (batchPosUpdates && lazyConnections) throw cRuntimeError("batchPosUpdates cannot be combined with lazyConnections, as there are no connections to update");
+
+        int connectionThreadsPar = hasPar("connectionThreads") ? par("connectionThreads").intValue() : 1;
+        if (connectionThreadsPar < 0) {
+            throw cRuntimeError("connectionThreads was %d, but must not be negative", connectionThreadsPar);
+        }
+        connectionThreads = (connectionThreadsPar > 0) ? connectionThreadsPar : std::max(1u, std::thread::hardware_concurrency());
+        if (batchPosUpdates && connectionThreads > 1) {
+            workerPool = make_unique<WorkerPool>(connectionThreads);
+        }
+
         maxInterferenceDistance = calcInterfDist();
         maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
 
@@ -107,20 +126,8 @@ void BaseConnectionManager::initialize(int stage)
             gridDim.z = std::max(1, gridDim.z);
         }
 
-        // step 2 - initialize the matrix which represents our grid
-        NicEntries entries;
-        RowVector row;
-        NicMatrix matrix;
-
-        for (int i = 0; i < gridDim.z; ++i) {
-            row.push_back(entries); // copy empty NicEntries to RowVector
-        }
-        for (int i = 0; i < gridDim.y; ++i) { // fill the ColVector with copies of
-            matrix.push_back(row); // the RowVector.
-        }
-        for (int i = 0; i < gridDim.x; ++i) { // fill the grid with copies of
-            nicGrid.push_back(matrix); // the matrix.
-        }
+        // step 2 - initialize the grid
+        nicGrid = NicGrid(gridDim, useTorus);
         EV_TRACE << " using " << gridDim.x << "x" << gridDim.y << "x" << gridDim.z << " grid" << endl;
 
         // step 3 -    calculate the factor which maps the coordinate of a node
@@ -164,15 +171,18 @@ BaseConnectionManager::GridCoord BaseConnectionManager::getCellForCoordinate(con
 
 void BaseConnectionManager::updateConnections(int nicID, Coord oldPos, Coord newPos)
 {
+    NicEntries::iterator ItNic = nics.find(nicID);
+    ASSERT(ItNic != nics.end());
+
     GridCoord oldCell = getCellForCoordinate(oldPos);
     GridCoord newCell = getCellForCoordinate(newPos);
 
-    checkGrid(oldCell, newCell, nicID);
-}
+    if (lazyConnections) {
+        nicGrid.update(ItNic->second, newCell);
+        return;
+    }
 
-BaseConnectionManager::NicEntries& BaseConnectionManager::getCellEntries(BaseConnectionManager::GridCoord& cell)
-{
-    return nicGrid[cell.x][cell.y][cell.z];
+    checkGrid(oldCell, newCell, ItNic->second);
 }
 
 void BaseConnectionManager::registerNicExt(int nicID)
@@ -183,92 +193,31 @@ void BaseConnectionManager::registerNicExt(int nicID)
 
     EV_TRACE << " registering (ext) nic at loc " << cell.info() << std::endl;
 
-    // add to matrix
-    NicEntries& cellEntries = getCellEntries(cell);
-    cellEntries[nicID] = nicEntry;
+    // add to grid
+    nicGrid.insert(nicEntry, cell);
 }
 
-void BaseConnectionManager::checkGrid(BaseConnectionManager::GridCoord& oldCell, BaseConnectionManager::GridCoord& newCell, int id)
+void BaseConnectionManager::checkGrid(BaseConnectionManager::GridCoord& oldCell, BaseConnectionManager::GridCoord& newCell, NicEntries::mapped_type nic)
 
 {
 
+    // move nic to a new position in the grid
+    nicGrid.update(nic, newCell);
+
     // structure to find union of grid squares
-    CoordSet gridUnion(74);
+    NicGrid::Neighborhood gridUnion;
 
-    // find nic at old position
-    NicEntries& oldCellEntries = getCellEntries(oldCell);
-    NicEntries::iterator it = oldCellEntries.find(id);
-    NicEntries::mapped_type nic = it->second;
+    // add grid around oldPos
+    nicGrid.addNeighborhood(gridUnion, oldCell);
 
-    // move nic to a new position in matrix
     if (oldCell != newCell) {
-        oldCellEntries.erase(it);
-        getCellEntries(newCell)[id] = nic;
-    }
-
-    if ((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-        gridUnion.add(oldCell);
-    }
-    else {
-        // add grid around oldPos
-        fillUnionWithNeighbors(gridUnion, oldCell);
-
-        if (oldCell != newCell) {
-            // add grid around newPos
-            fillUnionWithNeighbors(gridUnion, newCell);
-        }
+        // add grid around newPos
+        nicGrid.addNeighborhood(gridUnion, newCell);
     }
 
-    GridCoord* c = gridUnion.next();
-    while (c != nullptr) {
-        EV_TRACE << "Update cons in [" << c->info() << "]" << endl;
-        updateNicConnections(getCellEntries(*c), nic);
-        c = gridUnion.next();
-    }
-}
-
-int BaseConnectionManager::wrapIfTorus(int value, int max)
-{
-    if (value < 0) {
-        if (useTorus) {
-            return max + value;
-        }
-        else {
-            return -1;
-        }
-    }
-    else if (value >= max) {
-        if (useTorus) {
-            return value - max;
-        }
-        else {
-            return -1;
-        }
-    }
-    else {
-        return value;
-    }
-}
-
-void BaseConnectionManager::fillUnionWithNeighbors(CoordSet& gridUnion, GridCoord cell)
-{
-    for (int iz = (int) cell.z - 1; iz <= (int) cell.z + 1; iz++) {
-        int cz = wrapIfTorus(iz, gridDim.z);
-        if (cz == -1) {
-            continue;
-        }
-        for (int ix = (int) cell.x - 1; ix <= (int) cell.x + 1; ix++) {
-            int cx = wrapIfTorus(ix, gridDim.x);
-            if (cx == -1) {
-                continue;
-            }
-            for (int iy = (int) cell.y - 1; iy <= (int) cell.y + 1; iy++) {
-                int cy = wrapIfTorus(iy, gridDim.y);
-                if (cy != -1) {
-                    gridUnion.add(GridCoord(cx, cy, cz));
-                }
-            }
-        }
+    for (size_t c : gridUnion) {
+        EV_TRACE << "Update cons in cell #" << c << endl;
+        updateNicConnections(nicGrid.getCell(c), nic);
     }
 }
 
@@ -285,17 +234,17 @@ bool BaseConnectionManager::isInRange(BaseConnectionManager::NicEntries::mapped_
     return (dDistance <= maxDistSquared);
 }
 
-void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectionManager::NicEntries::mapped_type nic)
+void BaseConnectionManager::updateNicConnections(const NicGrid::Cell& cell, BaseConnectionManager::NicEntries::mapped_type nic)
 {
     int id = nic->nicId;
 
-    for (NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-        NicEntries::mapped_type nic_i = i->second;
+    for (const NicGrid::Slot& slot : cell) {
+        NicEntries::mapped_type nic_i = slot.nic;
 
         // no recursive connections
-        if (nic_i->nicId == id) continue;
+        if (nic_i == nic) continue;
 
-        bool inRange = isInRange(nic, nic_i);
+        bool inRange = mayBeInRange(nic->pos, slot.pos) && isInRange(nic, nic_i);
         bool connected = nic->isConnected(nic_i);
 
         if (inRange && !connected) {
@@ -322,6 +271,9 @@ bool BaseConnectionManager::registerNic(cModule* nic, ChannelAccess* chAccess, C
     int nicID = nic->getId();
     EV_TRACE << " registering nic #" << nicID << endl;
 
+    // connect to other nics at their current positions
+    flushNicPosUpdates();
+
     // create new NicEntry
     NicEntries::mapped_type nicEntry;
 
@@ -365,34 +317,29 @@ bool BaseConnectionManager::unregisterNic(cModule* nicModule)
     ASSERT(nics.find(nicID) != nics.end());
     NicEntries::mapped_type nicEntry = nics[nicID];
 
-    // get all affected grid squares
-    CoordSet gridUnion(74);
-    GridCoord cell = getCellForCoordinate(nicEntry->pos);
-    if ((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-        gridUnion.add(cell);
-    }
-    else {
-        fillUnionWithNeighbors(gridUnion, cell);
+    // disconnect from other nics at their current positions
+    flushNicPosUpdates();
+
+    // get all affected grid squares (none, if connections are not maintained)
+    NicGrid::Neighborhood gridUnion;
+    if (!lazyConnections) {
+        nicGrid.addNeighborhood(gridUnion, getCellForCoordinate(nicEntry->pos));
     }
 
     // disconnect from all NICs in these grid squares
-    GridCoord* c = gridUnion.next();
-    while (c != nullptr) {
-        EV_TRACE << "Update cons in [" << c->info() << "]" << endl;
-        NicEntries& nmap = getCellEntries(*c);
-        for (NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-            NicEntries::mapped_type other = i->second;
+    for (size_t c : gridUnion) {
+        EV_TRACE << "Update cons in cell #" << c << endl;
+        for (const NicGrid::Slot& slot : nicGrid.getCell(c)) {
+            NicEntries::mapped_type other = slot.nic;
             if (other == nicEntry) continue;
             if (!other->isConnected(nicEntry)) continue;
             other->disconnectFrom(nicEntry);
             nicEntry->disconnectFrom(other);
         }
-        c = gridUnion.next();
     }
 
     // erase from grid
-    NicEntries& cellEntries = getCellEntries(cell);
-    cellEntries.erase(nicID);
+    nicGrid.remove(nicEntry);
 
     // erase from list of known nics
     nics.erase(nicID);
@@ -411,17 +358,148 @@ void BaseConnectionManager::updateNicPos(int nicID, Coord newPos, Heading headin
     ItNic->second->pos = newPos;
     ItNic->second->heading = heading;
 
+    if (batchPosUpdates) {
+        if (!ItNic->second->posUpdatePending) {
+            ItNic->second->posUpdatePending = true;
+            pendingNics.push_back(ItNic->second);
+        }
+        return;
+    }
+
     updateConnections(nicID, oldPos, newPos);
 }
 
+void BaseConnectionManager::flushNicPosUpdates()
+{
+    if (pendingNics.empty()) return;
+
+    Enter_Method_Silent();
+
+    EV_TRACE << "updating connections of " << pendingNics.size() << " moved nics" << endl;
+
+    // move nics to their new cells, then sweep them cell by cell (so the same neighborhoods are scanned in a row)
+    for (auto nic : pendingNics) {
+        nicGrid.update(nic, getCellForCoordinate(nic->pos));
+    }
+    std::sort(pendingNics.begin(), pendingNics.end(), [](NicEntries::mapped_type a, NicEntries::mapped_type b) {
+        if (a->gridCell != b->gridCell) return a->gridCell < b->gridCell;
+        return a->nicId < b->nicId;
+    });
+    std::vector<size_t> runBegins;
+    for (size_t i = 0; i < pendingNics.size(); ++i) {
+        pendingNics[i]->sweepIndex = i;
+        if (i == 0 || pendingNics[i]->gridCell != pendingNics[i - 1]->gridCell) runBegins.push_back(i);
+    }
+    runBegins.push_back(pendingNics.size());
+    const size_t numRuns = runBegins.size() - 1;
+    if (pendingConnectsAndDisconnects.size() < numRuns) pendingConnectsAndDisconnects.resize(numRuns);
+
+    // runs of nics in the same cell are swept concurrently, as the grid and connections are not changed until all are done
+    std::atomic<size_t> nextRun(0);
+    auto sweepRuns = [this, &runBegins, numRuns, &nextRun]() {
+        for (size_t run = nextRun++; run < numRuns; run = nextRun++) {
+            NicPairs& connects = pendingConnectsAndDisconnects[run].first;
+            NicPairs& disconnects = pendingConnectsAndDisconnects[run].second;
+            connects.clear();
+            disconnects.clear();
+            for (size_t i = runBegins[run]; i < runBegins[run + 1]; ++i) {
+                sweepMovedNic(pendingNics[i], connects, disconnects);
+            }
+        }
+    };
+    if (workerPool) {
+        workerPool->run(sweepRuns, numRuns);
+    }
+    else {
+        sweepRuns();
+    }
+
+    for (auto nic : pendingNics) {
+        nic->posUpdatePending = false;
+    }
+    pendingNics.clear();
+
+    for (size_t run = 0; run < numRuns; ++run) {
+        for (auto& pair : pendingConnectsAndDisconnects[run].second) {
+            EV_TRACE << "nic #" << pair.first->nicId << " and #" << pair.second->nicId << " are NOT in range" << endl;
+            pair.first->disconnectFrom(pair.second);
+            pair.second->disconnectFrom(pair.first);
+        }
+    }
+    for (size_t run = 0; run < numRuns; ++run) {
+        for (auto& pair : pendingConnectsAndDisconnects[run].first) {
+            EV_TRACE << "nic #" << pair.first->nicId << " and #" << pair.second->nicId << " are in range" << endl;
+            pair.first->connectTo(pair.second);
+            pair.second->connectTo(pair.first);
+        }
+    }
+}
+
+void BaseConnectionManager::sweepMovedNic(NicEntries::mapped_type nic, NicPairs& connects, NicPairs& disconnects)
+{
+    // a pair of moved nics is checked by whichever comes last in the sweep
+    auto checkedByOther = [nic](NicEntries::mapped_type other) {
+        return other->posUpdatePending && other->sweepIndex > nic->sweepIndex;
+    };
+
+    // nics in range are in neighboring cells, but connected nics might be anywhere the nic was before
+    for (auto& connection : nic->getGateList()) {
+        // (entries are owned by this connection manager)
+        NicEntries::mapped_type other = const_cast<NicEntries::mapped_type>(connection.first);
+        if (checkedByOther(other)) continue;
+        if (isInRange(nic, other)) continue;
+        disconnects.emplace_back(nic, other);
+    }
+
+    NicGrid::Neighborhood neighborhood;
+    nicGrid.addNeighborhood(neighborhood, getCellForCoordinate(nic->pos));
+    for (size_t c : neighborhood) {
+        for (const NicGrid::Slot& slot : nicGrid.getCell(c)) {
+            NicEntries::mapped_type other = slot.nic;
+            if (other == nic || checkedByOther(other)) continue;
+            if (!mayBeInRange(nic->pos, slot.pos) || !isInRange(nic, other)) continue;
+            if (nic->isConnected(other)) continue;
+            connects.emplace_back(nic, other);
+        }
+    }
+}
+
 const NicEntry::GateList& BaseConnectionManager::getGateList(int nicID) const
 {
+    if (lazyConnections) throw cRuntimeError("Connections between nics are not maintained when using lazyConnections, use getReceiversInRange() instead.");
+
     NicEntries::const_iterator ItNic = nics.find(nicID);
     if (ItNic == nics.end()) throw cRuntimeError("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
 
     return ItNic->second->getGateList();
 }
 
+const BaseConnectionManager::Receivers& BaseConnectionManager::getReceiversInRange(int nicID)
+{
+    ASSERT(lazyConnections);
+
+    NicEntries::const_iterator ItNic = nics.find(nicID);
+    if (ItNic == nics.end()) throw cRuntimeError("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
+    NicEntries::mapped_type nic = ItNic->second;
+
+    NicGrid::Neighborhood neighborhood;
+    nicGrid.addNeighborhood(neighborhood, getCellForCoordinate(nic->pos));
+
+    receivers.clear();
+    for (size_t c : neighborhood) {
+        for (const NicGrid::Slot& slot : nicGrid.getCell(c)) {
+            NicEntries::mapped_type other = slot.nic;
+            if (other == nic) continue;
+            if (!mayBeInRange(nic->pos, slot.pos) || !isInRange(nic, other)) continue;
+            receivers.emplace_back(other, static_cast<NicEntryDirect*>(other)->getInGate());
+        }
+    }
+
+    // same order as getGateList(), so that results do not depend on whether connections are lazy
+    std::sort(receivers.begin(), receivers.end(), [](const Receivers::value_type& a, const Receivers::value_type& b) { return a.first->nicId < b.first->nicId; });
+    return receivers;
+}
+
 const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const
 {
     NicEntries::const_iterator ItNic = nics.find(nic->nicId);
@@ -432,6 +510,8 @@ const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic, const NicE
 
 BaseConnectionManager::~BaseConnectionManager()
 {
+    // stop worker threads before the nics they might access are gone
+    workerPool.reset();
     for (NicEntries::iterator ne = nics.begin(); ne != nics.end(); ne++) {
         delete ne->second;
     }
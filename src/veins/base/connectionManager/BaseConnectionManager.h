@@ -24,11 +24,17 @@
 
 #pragma once
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "veins/veins.h"
 
 #include "veins/base/utils/AntennaPosition.h"
 #include "veins/base/connectionManager/NicEntry.h"
+#include "veins/base/connectionManager/NicGrid.h"
 #include "veins/base/utils/Heading.h"
+#include "veins/base/utils/WorkerPool.h"
 
 namespace veins {
 
@@ -52,196 +58,8 @@ class ChannelAccess;
  */
 class VEINS_API BaseConnectionManager : public cSimpleModule {
 private:
-    /**
-     * @brief Represents a position inside a grid.
-     *
-     * Internal helper class of BaseConnectionManager.
-     * This class provides some converting functions from a Coord
-     * to a GridCoord.
-     */
-    class VEINS_API GridCoord {
-    public:
-        /** @name Coordinates in the grid.*/
-        /*@{*/
-        int x;
-        int y;
-        int z;
-        /*@}*/
-
-    public:
-        /**
-         * @brief Initialize this GridCoord with the origin.
-         * Creates a 3-dimensional coord.
-         */
-        GridCoord()
-            : x(0)
-            , y(0)
-            , z(0){};
-
-        /**
-         * @brief Initialize a 2-dimensional GridCoord with x and y.
-         */
-        GridCoord(int x, int y)
-            : x(x)
-            , y(y)
-            , z(0){};
-
-        /**
-         * @brief Initialize a 3-dimensional GridCoord with x, y and z.
-         */
-        GridCoord(int x, int y, int z)
-            : x(x)
-            , y(y)
-            , z(z){};
-
-        /**
-         * @brief Simple copy-constructor.
-         */
-        GridCoord(const GridCoord& o)
-        {
-            x = o.x;
-            y = o.y;
-            z = o.z;
-        }
-
-        /**
-         * @brief Creates a GridCoord from a given Coord by dividing the
-         * x,y and z-values by "gridCellWidth".
-         * The dimension of the GridCoord depends on the Coord.
-         */
-        GridCoord(const Coord& c, const Coord& gridCellSize = Coord(1.0, 1.0, 1.0))
-        {
-            x = static_cast<int>(c.x / gridCellSize.x);
-            y = static_cast<int>(c.y / gridCellSize.y);
-            z = static_cast<int>(c.z / gridCellSize.z);
-        }
-
-        /** @brief Output string for this coordinate.*/
-        std::string info() const
-        {
-            std::stringstream os;
-            os << "(" << x << "," << y << "," << z << ")";
-            return os.str();
-        }
-
-        /** @brief Comparison operator for coordinates.*/
-        friend bool operator==(const GridCoord& a, const GridCoord& b)
-        {
-            return a.x == b.x && a.y == b.y && a.z == b.z;
-        }
-
-        /** @brief Comparison operator for coordinates.*/
-        friend bool operator!=(const GridCoord& a, const GridCoord& b)
-        {
-            return !(a == b);
-        }
-    };
-
-    /**
-     * @brief Represents an minimalistic (hash)set of GridCoords.
-     *
-     * It is a workaround because c++ doesn't come with an hash set.
-     */
-    class VEINS_API CoordSet {
-    protected:
-        /** @brief Holds the hash table.*/
-        std::vector<GridCoord*> data;
-        /** @brief maximum size of the hash table.*/
-        unsigned maxSize;
-        /** @brief Current number of entries in the hash table.*/
-        unsigned size;
-        /** @brief Holds the current element when iterating over this table.*/
-        unsigned current;
-
-    protected:
-        /**
-         * @brief Tries to insert a GridCoord at the specified position.
-         *
-         * If the same Coord already exists there nothing happens.
-         * If an other Coord already exists there calculate
-         * a new Position to insert end recursively call this Method again.
-         * If the spot is empty the Coord is inserted.
-         */
-        void insert(const GridCoord& c, unsigned pos)
-        {
-            if (data[pos] == nullptr) {
-                data[pos] = new GridCoord(c);
-                size++;
-            }
-            else {
-                if (*data[pos] != c) {
-                    insert(c, (pos + 2) % maxSize);
-                }
-            }
-        }
-
-    public:
-        /**
-         * @brief Initializes the set (hashtable) with the a specified size.
-         */
-        CoordSet(unsigned sz)
-            : maxSize(sz)
-            , size(0)
-            , current(0)
-        {
-            data.resize(maxSize);
-        }
-
-        /**
-         * @brief Delete every created GridCoord
-         */
-        ~CoordSet()
-        {
-            for (unsigned i = 0; i < maxSize; i++) {
-                if (data[i] != nullptr) {
-                    delete data[i];
-                }
-            }
-        }
-
-        /**
-         * @brief Adds a GridCoord to the set.
-         * If a GridCoord with the same value already exists in the set
-         * nothing happens.
-         */
-        void add(const GridCoord& c)
-        {
-            unsigned hash = (c.x * 10000 + c.y * 100 + c.z) % maxSize;
-            insert(c, hash);
-        }
-
-        /**
-         * @brief Returns the next GridCoord in the set.
-         * You can iterate through the set only one time with this function!
-         */
-        GridCoord* next()
-        {
-            for (; current < maxSize; current++) {
-                if (data[current] != nullptr) {
-                    return data[current++];
-                }
-            }
-            return nullptr;
-        }
-
-        /**
-         * @brief Returns the number of GridCoords currently saved in this set.
-         */
-        unsigned getSize()
-        {
-            return size;
-        }
-
-        /**
-         * @brief Returns the maximum number of elements which can be stored inside
-         * this set.
-         * To prevent collisions the set should never be more than 75% filled.
-         */
-        unsigned getmaxSize()
-        {
-            return maxSize;
-        }
-    };
+    /** @brief Represents a position inside the grid.*/
+    using GridCoord = NicGrid::GridCoord;
 
 protected:
     /** @brief Type for map from nic-module id to nic-module pointer.*/
@@ -270,20 +88,48 @@ protected:
      * TkEnv.*/
     bool drawMIR;
 
-    /** @brief Type for 1-dimensional array of NicEntries.*/
-    using RowVector = std::vector<NicEntries>;
-    /** @brief Type for 2-dimensional array of NicEntries.*/
-    using NicMatrix = std::vector<RowVector>;
-    /** @brief Type for 3-dimensional array of NicEntries.*/
-    using NicCube = std::vector<NicMatrix>;
+    /** @brief Only keep nics in the grid and find the ones in range when
+     * sending (see getReceiversInRange()), rather than maintaining
+     * connections between them on every position update? */
+    bool lazyConnections;
+
+    /** @brief Type for list of nics in range of a sending nic, along with
+     * the gate to send to.*/
+    using Receivers = std::vector<std::pair<const NicEntry*, cGate*>>;
+
+    /** @brief Result of the last call to getReceiversInRange(), kept to
+     * reuse its memory.*/
+    Receivers receivers;
+
+    /** @brief Defer updating connections of moving nics until
+     * flushNicPosUpdates() is called? */
+    bool batchPosUpdates;
+
+    /** @brief Nics that moved since the last call to flushNicPosUpdates().*/
+    std::vector<NicEntries::mapped_type> pendingNics;
+
+    /** @brief Type for list of pairs of nics to connect or disconnect.*/
+    using NicPairs = std::vector<std::pair<NicEntries::mapped_type, NicEntries::mapped_type>>;
+
+    /** @brief Pairs of nics to connect and disconnect, collected by
+     * flushNicPosUpdates() per run of moved nics in the same cell (kept
+     * to reuse their memory).*/
+    std::vector<std::pair<NicPairs, NicPairs>> pendingConnectsAndDisconnects;
+
+    /** @brief Number of threads checking ranges in flushNicPosUpdates().*/
+    unsigned int connectionThreads;
+
+    /** @brief Threads helping to check ranges in flushNicPosUpdates() (if
+     * position updates are batched and connectionThreads > 1).*/
+    std::unique_ptr<WorkerPool> workerPool;
 
     /**
      * @brief Register of all nics
      *
-     * This matrix keeps all nics according to their position.  It
+     * This grid keeps all nics according to their position.  It
      * allows to restrict the position update to a subset of all nics.
      */
-    NicCube nicGrid;
+    NicGrid nicGrid;
 
     /**
      * @brief Distance that helps to find a node under a certain
@@ -300,12 +146,12 @@ protected:
 
 private:
     /** @brief Manages the connections of a registered nic. */
-    void updateNicConnections(NicEntries& nmap, NicEntries::mapped_type nic);
+    void updateNicConnections(const NicGrid::Cell& cell, NicEntries::mapped_type nic);
 
     /**
      * @brief Check connections of a nic in the grid
      */
-    void checkGrid(GridCoord& oldCell, GridCoord& newCell, int id);
+    void checkGrid(GridCoord& oldCell, GridCoord& newCell, NicEntries::mapped_type nic);
 
     /**
      * @brief Calculates the corresponding cell of a coordinate.
@@ -313,22 +159,26 @@ private:
     GridCoord getCellForCoordinate(const Coord& c);
 
     /**
-     * @brief Returns the NicEntries of the cell with specified
-     * coordinate.
-     */
-    NicEntries& getCellEntries(GridCoord& cell);
-
-    /**
-     * If the value is outside of its bounds (zero and max) this function
-     * returns -1 if useTorus is false and the wrapped value if useTorus is true.
-     * Otherwise its just returns the value unchanged.
+     * @brief Quick check whether nics at two positions might be in range.
+     *
+     * Nics further apart than the maximum interference distance are never
+     * in range (the grid could not find them reliably anyway), so this
+     * rules out most nics in neighboring cells based on the positions
+     * stored in the grid before asking isInRange().
      */
-    int wrapIfTorus(int value, int max);
+    bool mayBeInRange(const Coord& a, const Coord& b) const
+    {
+        return useTorus || a.sqrdist(b) <= maxDistSquared;
+    }
 
     /**
-     * @brief Adds every direct Neighbor of a GridCoord to a union of coords.
+     * @brief Collects the pairs of nics to connect and disconnect because
+     * a nic has moved, as part of flushNicPosUpdates().
+     *
+     * Only reads nics and the grid, so it can run concurrently for
+     * different nics.
      */
-    void fillUnionWithNeighbors(CoordSet& gridUnion, GridCoord cell);
+    void sweepMovedNic(NicEntries::mapped_type nic, NicPairs& connects, NicPairs& disconnects);
 
 protected:
     /**
@@ -420,12 +270,60 @@ public:
      */
     bool unregisterNic(cModule* nic);
 
-    /** @brief Updates the position information of a registered nic.*/
+    /**
+     * @brief Updates the position information of a registered nic.
+     *
+     * If position updates are batched, connections are only updated on
+     * the next call to flushNicPosUpdates().
+     */
     void updateNicPos(int nicID, Coord newPos, Heading heading);
 
+    /** @brief Returns whether position updates of nics are batched (see
+     * flushNicPosUpdates()).*/
+    bool usesBatchPosUpdates() const
+    {
+        return batchPosUpdates;
+    }
+
+    /**
+     * @brief Updates the connections of all nics that moved since the last
+     * call at once.
+     *
+     * Moved nics are swept in order of their grid cells. Each pair of nics
+     * is only checked once (rather than from both sides), then all
+     * disconnections and connections are made in bulk.
+     * Ranges of nics in different cells are checked on up to
+     * connectionThreads threads (so isInRange() must be thread safe),
+     * but results are merged in sweep order and connections are only
+     * changed from the simulation's thread, so they do not depend on the
+     * number of threads.
+     *
+     * Called by TraCIScenarioManager at the end of each timestep, as well
+     * as before nics send, register or unregister. Does nothing unless
+     * position updates are batched.
+     */
+    void flushNicPosUpdates();
+
     /** @brief Returns the ingates of all nics in range*/
     const NicEntry::GateList& getGateList(int nicID) const;
 
+    /** @brief Returns whether nics in range are only determined when
+     * sending (see getReceiversInRange()) rather than maintained (see
+     * getGateList()).*/
+    bool usesLazyConnections() const
+    {
+        return lazyConnections;
+    }
+
+    /**
+     * @brief Returns all nics currently in range of the nic with id nicID
+     * (ordered by id, as in getGateList()) along with the gate to send to.
+     *
+     * Only available if connections are lazy. The result stays valid
+     * until the next call.
+     */
+    const Receivers& getReceiversInRange(int nicID);
+
     /** @brief Returns the ingate of the with id==targetID, or 0 if not in range*/
     const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const;
 };
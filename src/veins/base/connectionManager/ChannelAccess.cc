@@ -80,32 +80,78 @@ void ChannelAccess::initialize(int stage)
     usePropagationDelay = par("usePropagationDelay");
 }
 
-void ChannelAccess::sendToChannel(cPacket* msg)
+void ChannelAccess::sendToChannel(cPacket* msg, double maxDistance)
 {
     EV_TRACE << "sendToChannel: sending to gates\n";
 
-    const auto& gateList = cc->getGateList(getParentModule()->getId());
+    const int nicId = getParentModule()->getId();
+    cc->flushNicPosUpdates();
+    if (cc->usesLazyConnections()) {
+        sendToGates(msg, cc->getReceiversInRange(nicId), maxDistance);
+    }
+    else {
+        sendToGates(msg, cc->getGateList(nicId), maxDistance);
+    }
+}
+
+template <typename Gates>
+void ChannelAccess::sendToGates(cPacket* msg, const Gates& gates, double maxDistance)
+{
+    const bool checkDistance = maxDistance < std::numeric_limits<double>::infinity();
+    const Coord senderPos = antennaPosition.getPositionAt();
+    const simtime_t duration = msg->getDuration();
+
+    // every receiver gets a copy, except for the last one, which gets the original message
+    struct Delivery {
+        cGate* gate;
+        int gateIndex; // -1 if not using sendDirect
+        simtime_t propagationDelay;
+    };
+    Delivery previous;
+    bool hasPrevious = false;
+    auto deliver = [this, duration](const Delivery& delivery, cPacket* packet) {
+        if (delivery.gateIndex >= 0) {
+            sendDirect(packet, delivery.propagationDelay, duration, delivery.gate->getOwnerModule(), delivery.gateIndex);
+        }
+        else {
+            sendDelayed(packet, delivery.propagationDelay, delivery.gate);
+        }
+    };
+    auto enqueue = [msg, &previous, &hasPrevious, &deliver](const Delivery& delivery) {
+        if (hasPrevious) deliver(previous, msg->dup());
+        previous = delivery;
+        hasPrevious = true;
+    };
+
+    for (auto&& entry : gates) {
+        if (checkDistance && senderPos.sqrdist(entry.first->chAccess->antennaPosition.getPositionAt()) > maxDistance * maxDistance) continue;
+        if (isNegligibleAt(msg, entry.first->chAccess)) continue;
 
-    for (auto&& entry : gateList) {
         const auto gate = entry.second;
         const auto propagationDelay = calculatePropagationDelay(entry.first);
 
         if (useSendDirect) {
             if (gate->isVector()) {
                 for (int gateIndex = gate->getBaseId(); gateIndex < gate->getBaseId() + gate->size(); gateIndex++) {
-                    sendDirect(msg->dup(), propagationDelay, msg->getDuration(), gate->getOwnerModule(), gateIndex);
+                    enqueue({gate, gateIndex, propagationDelay});
                 }
             }
             else {
-                sendDirect(msg->dup(), propagationDelay, msg->getDuration(), gate->getOwnerModule(), gate->getBaseId());
+                enqueue({gate, gate->getBaseId(), propagationDelay});
             }
         }
         else {
-            sendDelayed(msg->dup(), propagationDelay, gate);
+            enqueue({gate, -1, propagationDelay});
         }
     }
-    // Original message no longer needed, copies have been sent to all possible receivers.
-    delete msg;
+
+    if (hasPrevious) {
+        deliver(previous, msg);
+    }
+    else {
+        // no receivers
+        delete msg;
+    }
 }
 
 simtime_t ChannelAccess::calculatePropagationDelay(const NicEntry* nic)
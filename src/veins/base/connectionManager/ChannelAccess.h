@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <limits>
 #include <vector>
 
 #include "veins/veins.h"
@@ -104,8 +105,25 @@ protected:
      *
      * depending on which ConnectionManager module is used, the messages are
      * send via sendDirect() or to the respective gates.
+     *
+     * Nics whose antenna is further away than maxDistance do not get a
+     * copy of the message.
      **/
-    void sendToChannel(cPacket* msg);
+    void sendToChannel(cPacket* msg, double maxDistance = std::numeric_limits<double>::infinity());
+
+    /**
+     * @brief Returns whether msg would arrive at receiver with negligible power, so it need not be sent there.
+     *
+     * Called by sendToChannel for every receiver in range. The default implementation never culls receivers.
+     */
+    virtual bool isNegligibleAt(const cPacket* msg, ChannelAccess* receiver)
+    {
+        return false;
+    }
+
+    /** @brief Sends a copy of msg to each (nic, gate) pair in gates within maxDistance, taking ownership of msg. */
+    template <typename Gates>
+    void sendToGates(cPacket* msg, const Gates& gates, double maxDistance);
 
 public:
     /**
@@ -79,6 +79,18 @@ public:
     /** @brief Points to this nics ChannelAccess module */
     ChannelAccess* chAccess;
 
+    /** @brief Index of the NicGrid cell this nic is stored in */
+    size_t gridCell = 0;
+
+    /** @brief Position of this nic within its NicGrid cell */
+    size_t gridSlot = 0;
+
+    /** @brief Has this nic moved since connections were last updated (see BaseConnectionManager::flushNicPosUpdates())? */
+    bool posUpdatePending = false;
+
+    /** @brief Position of this nic in the sweep over moved nics (only valid while posUpdatePending) */
+    size_t sweepIndex = 0;
+
 protected:
     /** @brief Outgoing connections of this nic
      *
@@ -33,14 +33,20 @@ using namespace veins;
 
 void NicEntryDirect::connectTo(NicEntry* other)
 {
-    cModule* otherPtr = other->nicPtr;
-
     EV_TRACE << "connecting nic #" << nicId << " and #" << other->nicId << endl;
 
+    outConns[other] = static_cast<NicEntryDirect*>(other)->getInGate();
+}
+
+cGate* NicEntryDirect::getInGate()
+{
+    if (inGate) return inGate;
+
     cGate* radioGate = nullptr;
-    if ((radioGate = otherPtr->gate("radioIn")) == nullptr) throw cRuntimeError("Nic has no radioIn gate!");
+    if ((radioGate = nicPtr->gate("radioIn")) == nullptr) throw cRuntimeError("Nic has no radioIn gate!");
 
-    outConns[other] = radioGate->getPathStartGate();
+    inGate = radioGate->getPathStartGate();
+    return inGate;
 }
 
 void NicEntryDirect::disconnectFrom(NicEntry* other)
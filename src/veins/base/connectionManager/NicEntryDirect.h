@@ -72,6 +72,13 @@ public:
      * @param other reference to remote nic (other NicEntry)
      */
     void disconnectFrom(NicEntry*) override;
+
+    /** @brief Returns the gate other nics send to in order to reach this nic */
+    cGate* getInGate();
+
+protected:
+    /** @brief Cached result of getInGate() */
+    cGate* inGate = nullptr;
 };
 
 } // namespace veins
@@ -0,0 +1,109 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/connectionManager/NicGrid.h"
+
+#include "veins/base/connectionManager/NicEntry.h"
+
+using namespace veins;
+
+NicGrid::NicGrid(const GridCoord& dim, bool useTorus)
+    : dim(dim)
+    , useTorus(useTorus)
+    , cells(static_cast<size_t>(dim.x) * dim.y * dim.z)
+{
+}
+
+void NicGrid::insert(NicEntry* nic, const GridCoord& cell)
+{
+    nic->gridCell = getIndex(cell);
+    Cell& entries = cells[nic->gridCell];
+    nic->gridSlot = entries.size();
+    entries.push_back({nic->pos, nic});
+}
+
+void NicGrid::remove(NicEntry* nic)
+{
+    Cell& entries = cells[nic->gridCell];
+    ASSERT(nic->gridSlot < entries.size() && entries[nic->gridSlot].nic == nic);
+
+    // fill the gap with the last nic of the cell
+    if (nic->gridSlot != entries.size() - 1) {
+        entries[nic->gridSlot] = entries.back();
+        entries[nic->gridSlot].nic->gridSlot = nic->gridSlot;
+    }
+    entries.pop_back();
+}
+
+void NicGrid::update(NicEntry* nic, const GridCoord& cell)
+{
+    if (getIndex(cell) != nic->gridCell) {
+        remove(nic);
+        insert(nic, cell);
+    }
+    else {
+        cells[nic->gridCell][nic->gridSlot].pos = nic->pos;
+    }
+}
+
+int NicGrid::wrapIfTorus(int value, int max) const
+{
+    if (value < 0) {
+        if (useTorus) {
+            return max + value;
+        }
+        else {
+            return -1;
+        }
+    }
+    else if (value >= max) {
+        if (useTorus) {
+            return value - max;
+        }
+        else {
+            return -1;
+        }
+    }
+    else {
+        return value;
+    }
+}
+
+void NicGrid::addNeighborhood(Neighborhood& neighborhood, const GridCoord& cell) const
+{
+    for (int iz = cell.z - 1; iz <= cell.z + 1; iz++) {
+        int cz = wrapIfTorus(iz, dim.z);
+        if (cz == -1) {
+            continue;
+        }
+        for (int ix = cell.x - 1; ix <= cell.x + 1; ix++) {
+            int cx = wrapIfTorus(ix, dim.x);
+            if (cx == -1) {
+                continue;
+            }
+            for (int iy = cell.y - 1; iy <= cell.y + 1; iy++) {
+                int cy = wrapIfTorus(iy, dim.y);
+                if (cy != -1) {
+                    neighborhood.add(getIndex(GridCoord(cx, cy, cz)));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,254 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+class NicEntry;
+
+/**
+ * @brief Grid of nics, as used by BaseConnectionManager to only check
+ * nics in neighboring cells for connections.
+ *
+ * Each cell densely packs the position and entry of every nic it
+ * contains, so scanning a cell touches contiguous memory only.
+ * Nics are swap-removed from their old cell when changing cells, so the
+ * order of nics within a cell is not stable.
+ * Each nic remembers its cell and slot (see NicEntry::gridCell and
+ * NicEntry::gridSlot), so a nic can be in at most one NicGrid.
+ *
+ * @ingroup connectionManager
+ * @sa BaseConnectionManager
+ */
+class VEINS_API NicGrid {
+public:
+    /**
+     * @brief Represents a position inside a grid.
+     *
+     * This class provides some converting functions from a Coord
+     * to a GridCoord.
+     */
+    class VEINS_API GridCoord {
+    public:
+        /** @name Coordinates in the grid.*/
+        /*@{*/
+        int x;
+        int y;
+        int z;
+        /*@}*/
+
+    public:
+        /**
+         * @brief Initialize this GridCoord with the origin.
+         * Creates a 3-dimensional coord.
+         */
+        GridCoord()
+            : x(0)
+            , y(0)
+            , z(0){};
+
+        /**
+         * @brief Initialize a 2-dimensional GridCoord with x and y.
+         */
+        GridCoord(int x, int y)
+            : x(x)
+            , y(y)
+            , z(0){};
+
+        /**
+         * @brief Initialize a 3-dimensional GridCoord with x, y and z.
+         */
+        GridCoord(int x, int y, int z)
+            : x(x)
+            , y(y)
+            , z(z){};
+
+        /**
+         * @brief Simple copy-constructor.
+         */
+        GridCoord(const GridCoord& o)
+        {
+            x = o.x;
+            y = o.y;
+            z = o.z;
+        }
+
+        /**
+         * @brief Creates a GridCoord from a given Coord by dividing the
+         * x,y and z-values by "gridCellWidth".
+         * The dimension of the GridCoord depends on the Coord.
+         */
+        GridCoord(const Coord& c, const Coord& gridCellSize = Coord(1.0, 1.0, 1.0))
+        {
+            x = static_cast<int>(c.x / gridCellSize.x);
+            y = static_cast<int>(c.y / gridCellSize.y);
+            z = static_cast<int>(c.z / gridCellSize.z);
+        }
+
+        /** @brief Output string for this coordinate.*/
+        std::string info() const
+        {
+            std::stringstream os;
+            os << "(" << x << "," << y << "," << z << ")";
+            return os.str();
+        }
+
+        /** @brief Comparison operator for coordinates.*/
+        friend bool operator==(const GridCoord& a, const GridCoord& b)
+        {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        }
+
+        /** @brief Comparison operator for coordinates.*/
+        friend bool operator!=(const GridCoord& a, const GridCoord& b)
+        {
+            return !(a == b);
+        }
+    };
+
+    /**
+     * @brief A nic stored in a cell, along with a copy of its position
+     * (so distances can be checked without dereferencing the nic).
+     */
+    struct Slot {
+        Coord pos;
+        NicEntry* nic;
+    };
+
+    /** @brief Type for the nics in one cell, in no particular order.*/
+    using Cell = std::vector<Slot>;
+
+    /**
+     * @brief Set of distinct cells (given by their index), e.g., the
+     * neighborhoods of the old and the new cell of a moving nic.
+     *
+     * Stored on the stack, so collecting cells does not allocate memory.
+     */
+    class VEINS_API Neighborhood {
+    public:
+        /** @brief Enough for two cells and all of their direct neighbors.*/
+        static constexpr size_t maxSize = 2 * 27;
+
+        /** @brief Adds a cell, unless it already is in the set.*/
+        void add(size_t cell)
+        {
+            if (std::find(begin(), end(), cell) != end()) return;
+            ASSERT(count < maxSize);
+            cells[count++] = cell;
+        }
+
+        const size_t* begin() const
+        {
+            return cells.data();
+        }
+
+        const size_t* end() const
+        {
+            return cells.data() + count;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+    private:
+        std::array<size_t, maxSize> cells;
+        size_t count = 0;
+    };
+
+public:
+    NicGrid() = default;
+
+    /**
+     * @brief Creates an empty grid of dim.x * dim.y * dim.z cells.
+     *
+     * If useTorus is true, the cells at opposite borders of the grid are
+     * neighbors of each other.
+     */
+    NicGrid(const GridCoord& dim, bool useTorus);
+
+    /** @brief Returns the number of cells along each axis.*/
+    const GridCoord& getDim() const
+    {
+        return dim;
+    }
+
+    /** @brief Returns the index of a cell, as used by Neighborhood and getCell().*/
+    size_t getIndex(const GridCoord& cell) const
+    {
+        ASSERT(cell.x >= 0 && cell.x < dim.x && cell.y >= 0 && cell.y < dim.y && cell.z >= 0 && cell.z < dim.z);
+        return (static_cast<size_t>(cell.x) * dim.y + cell.y) * dim.z + cell.z;
+    }
+
+    /** @brief Returns the nics in the cell with index index.*/
+    const Cell& getCell(size_t index) const
+    {
+        return cells[index];
+    }
+
+    /** @brief Adds a nic (at its current position) to a cell.*/
+    void insert(NicEntry* nic, const GridCoord& cell);
+
+    /** @brief Removes a nic from its cell.*/
+    void remove(NicEntry* nic);
+
+    /**
+     * @brief Records the current position of a nic, moving it to
+     * another cell if needed.
+     */
+    void update(NicEntry* nic, const GridCoord& cell);
+
+    /**
+     * @brief Adds a cell and all of its direct neighbors to a
+     * Neighborhood.
+     */
+    void addNeighborhood(Neighborhood& neighborhood, const GridCoord& cell) const;
+
+private:
+    /**
+     * If the value is outside of its bounds (zero and max) this function
+     * returns -1 if useTorus is false and the wrapped value if useTorus is true.
+     * Otherwise its just returns the value unchanged.
+     */
+    int wrapIfTorus(int value, int max) const;
+
+    /** @brief The number of cells along each axis.*/
+    GridCoord dim;
+
+    /** @brief Are cells at opposite borders neighbors?*/
+    bool useTorus = false;
+
+    /** @brief All cells, see getIndex().*/
+    std::vector<Cell> cells;
+};
+
+} // namespace veins
@@ -26,6 +26,7 @@
 
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/utils/FindModule.h"
+#include "veins/base/utils/RecyclingPool.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
 
 using namespace veins;
@@ -41,6 +42,11 @@ void BaseWorldUtility::initialize(int stage)
 {
     if (stage == 0) {
         initializeIfNecessary();
+
+        // pools outlive simulation runs, only count allocations of this run
+        for (auto pool : RecyclingPool::getPools()) {
+            pool->resetCounters();
+        }
     }
     else if (stage == 1) {
         // check if necessary modules are there
@@ -51,6 +57,14 @@ void BaseWorldUtility::initialize(int stage)
     }
 }
 
+void BaseWorldUtility::finish()
+{
+    for (auto pool : RecyclingPool::getPools()) {
+        recordScalar((pool->getName() + "Allocations").c_str(), pool->getNumAllocations());
+        recordScalar((pool->getName() + "Reuses").c_str(), pool->getNumReuses());
+    }
+}
+
 void BaseWorldUtility::initializeIfNecessary()
 {
     if (isInitialized) return;
@@ -81,6 +81,9 @@ public:
 
     void initialize(int stage) override;
 
+    /** @brief Records how many objects were allocated from (and reused by) each RecyclingPool.*/
+    void finish() override;
+
     /**
      * @brief Returns the playgroundSize
      *
@@ -77,6 +77,24 @@ public:
     {
         return false;
     }
+
+    /**
+     * If the model only multiplies a signal by an attenuation which depends on nothing but the positions and orientations of sender and receiver and the spectrum of the signal, it returns true here.
+     * This allows reusing the attenuation for frames on the same link, see BasePhyLayer's cacheLinkBudget parameter.
+     */
+    virtual bool dependsOnlyOnLinkGeometry()
+    {
+        return false;
+    }
+
+    /**
+     * If dependsOnlyOnLinkGeometry returns true, but the attenuation of a link can still change during the simulation (e.g., as obstacles are added or removed), this returns a number which changes whenever it does.
+     * Attenuations reused for frames on the same link are discarded when this number changes.
+     */
+    virtual unsigned long getLinkGeometryGeneration()
+    {
+        return 0;
+    }
 };
 
 using AnalogueModelList = std::vector<std::unique_ptr<AnalogueModel>>;
@@ -24,6 +24,10 @@
 
 #include "veins/base/phyLayer/BasePhyLayer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -32,6 +36,7 @@
 #include "veins/base/utils/POA.h"
 #include "veins/modules/phy/SampledAntenna1D.h"
 #include "veins/base/phyLayer/AnalogueModel.h"
+#include "veins/base/phyLayer/CachedAnalogueModel.h"
 #include "veins/base/phyLayer/Decider.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
@@ -89,6 +94,20 @@ void BasePhyLayer::initialize(int stage)
         minPowerLevel = par("minPowerLevel").doubleValue();
         minPowerLevel = FWMath::dBm2mW(minPowerLevel);
 
+        interferenceCutoffAlpha = par("interferenceCutoffAlpha").doubleValue();
+        if (interferenceCutoffAlpha < 0) {
+            throw cRuntimeError("interferenceCutoffAlpha was %f, but must not be negative", interferenceCutoffAlpha);
+        }
+        interferenceCutoffGain = pow(10, par("interferenceCutoffGain").doubleValue() / 10);
+        cullNegligibleReceivers = par("cullNegligibleReceivers").boolValue();
+        negligibleInterferenceLevel = FWMath::dBm2mW(par("negligibleInterferenceLevel").doubleValue());
+        if (par("trackInterference").boolValue()) {
+            interferenceTracker = make_unique<InterferenceTracker>();
+        }
+        if (par("cacheLinkBudget").boolValue()) {
+            linkBudgetCache = make_unique<LinkBudgetCache>();
+        }
+
         recordStats = par("recordStats").boolValue();
 
         radio = initializeRadio();
@@ -184,6 +203,25 @@ void BasePhyLayer::finish()
     if (decider != nullptr) {
         decider->finish();
     }
+
+    if (cullNegligibleReceivers) {
+        recordScalar("NegligibleReceiversSkipped", numNegligibleReceivers);
+    }
+    if (linkBudgetCache) {
+        recordScalar("LinkBudgetCacheHits", linkBudgetCache->getNumHits());
+        recordScalar("LinkBudgetCacheMisses", linkBudgetCache->getNumMisses());
+
+        long numThresholdingHits = 0;
+        long numThresholdingMisses = 0;
+        for (auto& analogueModel : analogueModelsThresholding) {
+            if (auto cachedModel = dynamic_cast<CachedAnalogueModel*>(analogueModel.get())) {
+                numThresholdingHits += cachedModel->getCache().getNumHits();
+                numThresholdingMisses += cachedModel->getCache().getNumMisses();
+            }
+        }
+        recordScalar("ThresholdingLinkBudgetCacheHits", numThresholdingHits);
+        recordScalar("ThresholdingLinkBudgetCacheMisses", numThresholdingMisses);
+    }
 }
 
 // -----Decider initialization----------------------
@@ -369,6 +407,20 @@ void BasePhyLayer::initializeAnalogueModels(cXMLElement* xmlConfig)
 
         EV_TRACE << "AnalogueModel \"" << name << "\" loaded." << endl;
     }
+
+    // move models which only depend on the link geometry to the cached link budget
+    // (thresholding models stay lazy, so they are still not applied to frames which are not decoded, but each caches its attenuation once it was applied)
+    if (linkBudgetCache) {
+        auto firstMoved = std::stable_partition(analogueModels.begin(), analogueModels.end(), [](const std::unique_ptr<AnalogueModel>& model) { return !model->dependsOnlyOnLinkGeometry(); });
+        std::move(firstMoved, analogueModels.end(), std::back_inserter(analogueModelsLinkBudget));
+        analogueModels.erase(firstMoved, analogueModels.end());
+
+        for (auto& analogueModel : analogueModelsThresholding) {
+            if (analogueModel->dependsOnlyOnLinkGeometry()) {
+                analogueModel = make_unique<CachedAnalogueModel>(this, std::move(analogueModel));
+            }
+        }
+    }
 }
 
 // --Message handling--------------------------------------
@@ -442,6 +494,10 @@ void BasePhyLayer::handleAirFrameStartReceive(AirFrame* frame)
 
     filterSignal(frame);
 
+    if (interferenceTracker) {
+        interferenceTracker->add(frame, simTime());
+    }
+
     if (decider && isKnownProtocolId(frame->getProtocolId())) {
         frame->setState(static_cast<int>(AirFrameState::receiving));
 
@@ -496,7 +552,10 @@ void BasePhyLayer::handleAirFrameEndReceive(AirFrame* frame)
 {
     EV_TRACE << "End of Airframe with ID " << frame->getId() << "." << endl;
 
-    simtime_t earliestInfoPoint = channelInfo.removeAirFrame(frame);
+    simtime_t earliestInfoPoint = channelInfo.removeAirFrame(frame, frame->getSignal().getReceptionStart());
+    if (interferenceTracker) {
+        interferenceTracker->remove(frame, simTime());
+    }
 
     /* clean information in the radio until earliest time-point
      * of information in the ChannelInfo,
@@ -630,7 +689,24 @@ void BasePhyLayer::sendMacPktUp(cMessage* pkt)
 void BasePhyLayer::sendMessageDown(AirFrame* msg)
 {
 
-    sendToChannel(msg);
+    sendToChannel(msg, calcInterferenceCutoffDistance(msg));
+}
+
+double BasePhyLayer::calcInterferenceCutoffDistance(const AirFrame* frame) const
+{
+    if (interferenceCutoffAlpha == 0) return std::numeric_limits<double>::infinity();
+
+    const Signal& signal = frame->getConstSignal();
+    const double txPower = signal.getMax();
+    if (txPower <= 0) return 0;
+
+    // the lowest frequency carrying power suffers the least free-space pathloss
+    const double frequency = signal.getSpectrum()[signal.getDataStart()];
+    const double pathlossAt1m = std::pow(4 * M_PI * frequency / BaseWorldUtility::speedOfLight(), 2);
+
+    // solve txPower * interferenceCutoffGain / (pathlossAt1m * distance^interferenceCutoffAlpha) = minPowerLevel for distance (but never less than 1m)
+    const double maxPathloss = txPower * interferenceCutoffGain / (minPowerLevel * pathlossAt1m);
+    return std::max(1.0, std::pow(maxPathloss, 1 / interferenceCutoffAlpha));
 }
 
 void BasePhyLayer::sendSelfMessage(cMessage* msg, simtime_t_cref time)
@@ -647,11 +723,24 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
     ASSERT(dynamic_cast<ChannelAccess* const>(frame->getSenderModule()));
     Signal& signal = frame->getSignal();
 
+    // get POA from frame with the sender's position, orientation and antenna
+    attachAntennaGains(signal, frame->getPoa());
+
+    // go on with AnalogueModels
+    // attach analogue models suitable for thresholding to signal (for later evaluation)
+    signal.setAnalogueModelList(&analogueModelsThresholding);
+
+    // apply all analouge models that are *not* suitable for thresholding now
+    for (auto& analogueModel : analogueModels) {
+        analogueModel->filterSignal(&signal);
+    }
+}
+
+void BasePhyLayer::attachAntennaGains(Signal& signal, const POA& senderPOA)
+{
     // Extract position and orientation of sender and receiver (this module) first
     const AntennaPosition receiverPosition = antennaPosition;
     const Coord receiverOrientation = antennaHeading.toCoord();
-    // get POA from frame with the sender's position, orientation and antenna
-    POA& senderPOA = frame->getPoa();
     const AntennaPosition senderPosition = senderPOA.pos;
     const Coord senderOrientation = senderPOA.orientation;
 
@@ -659,6 +748,16 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
     signal.setSenderPoa(senderPOA);
     signal.setReceiverPoa({receiverPosition, receiverOrientation, antenna});
 
+    // reuse the link budget if neither antenna moved or turned (and no model changed, e.g., its obstacles) since it was computed
+    LinkBudgetCache::Link link;
+    if (linkBudgetCache) {
+        link = {senderPosition.getPositionAt(), senderOrientation, receiverPosition.getPositionAt(), receiverOrientation};
+        for (auto& analogueModel : analogueModelsLinkBudget) {
+            link.generation += analogueModel->getLinkGeometryGeneration();
+        }
+        if (linkBudgetCache->apply(senderPosition.getId(), link, signal, simTime())) return;
+    }
+
     // compute gains at sender and receiver antenna
     double receiverGain = antenna->getGain(receiverPosition.getPositionAt(), receiverOrientation, senderPosition.getPositionAt());
     double senderGain = senderPOA.antenna->getGain(senderPosition.getPositionAt(), senderOrientation, receiverPosition.getPositionAt());
@@ -666,16 +765,51 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
     // add the resulting total gain to the attenuations list
     EV_TRACE << "Sender's antenna gain: " << senderGain << endl;
     EV_TRACE << "Own (receiver's) antenna gain: " << receiverGain << endl;
-    signal *= receiverGain * senderGain;
 
-    // go on with AnalogueModels
-    // attach analogue models suitable for thresholding to signal (for later evaluation)
-    signal.setAnalogueModelList(&analogueModelsThresholding);
+    if (!linkBudgetCache) {
+        signal *= receiverGain * senderGain;
+        return;
+    }
 
-    // apply all analouge models that are *not* suitable for thresholding now
-    for (auto& analogueModel : analogueModels) {
-        analogueModel->filterSignal(&signal);
+    // compute the link budget on a signal without timing (so models see the same sender and receiver, but it fits any frame)
+    Signal gain(signal.getSpectrum());
+    gain.setSenderPoa(signal.getSenderPoa());
+    gain.setReceiverPoa(signal.getReceiverPoa());
+    gain = receiverGain * senderGain;
+    for (auto& analogueModel : analogueModelsLinkBudget) {
+        analogueModel->filterSignal(&gain);
+    }
+    linkBudgetCache->store(senderPosition.getId(), link, gain, simTime());
+    signal *= gain;
+}
+
+bool BasePhyLayer::isNegligibleAt(const cPacket* msg, ChannelAccess* receiver)
+{
+    if (!cullNegligibleReceivers) return false;
+
+    BasePhyLayer* receiverPhy = dynamic_cast<BasePhyLayer*>(receiver);
+    if (!receiverPhy) return false;
+    if (!receiverPhy->arrivesBelow(check_and_cast<const AirFrame*>(msg), negligibleInterferenceLevel)) return false;
+
+    EV_TRACE << "Not sending AirFrame to " << receiverPhy->getFullPath() << ", power would be negligible" << endl;
+    numNegligibleReceivers++;
+    return true;
+}
+
+bool BasePhyLayer::arrivesBelow(const AirFrame* frame, double powerLevel)
+{
+    Enter_Method_Silent();
+
+    // only receivers whose eagerly applied analogue models never increase power give an upper bound for the received power
+    for (const auto& analogueModel : analogueModels) {
+        if (!analogueModel->neverIncreasesPower()) return false;
     }
+
+    // apply the antenna gains and (as few as needed of) the thresholding analogue models to a scratch copy of the signal, as the decider would
+    cullingSignal = frame->getConstSignal();
+    attachAntennaGains(cullingSignal, frame->getConstPoa());
+    cullingSignal.setAnalogueModelList(&analogueModelsThresholding);
+    return cullingSignal.smallerAtCenterFrequency(powerLevel);
 }
 
 // --Destruction--------------------------------
@@ -773,6 +907,11 @@ void BasePhyLayer::getChannelInfo(simtime_t_cref from, simtime_t_cref to, AirFra
     channelInfo.getAirFrames(from, to, out);
 }
 
+InterferenceTracker* BasePhyLayer::getInterferenceTracker()
+{
+    return interferenceTracker.get();
+}
+
 double BasePhyLayer::getNoiseFloorValue()
 {
     return noiseFloorValue;
@@ -36,6 +36,8 @@
 #include "veins/base/phyLayer/MacToPhyInterface.h"
 #include "veins/base/phyLayer/Antenna.h"
 #include "veins/base/phyLayer/ChannelInfo.h"
+#include "veins/base/phyLayer/InterferenceTracker.h"
+#include "veins/base/phyLayer/LinkBudgetCache.h"
 
 namespace veins {
 
@@ -116,8 +118,16 @@ protected:
     int protocolId = PROTOCOL_ID_GENERIC; ///< The ID of the protocol this phy can transceive.
     double noiseFloorValue = 0; ///< Catch-all for all factors negatively impacting SINR (e.g., thermal noise, noise figure, ...)
     double minPowerLevel; ///< The minimum receive power needed to even attempt decoding a frame.
+    double interferenceCutoffAlpha = 0; ///< Pathloss exponent assumed when computing the distance beyond which frames are not sent (0 to send to all receivers).
+    double interferenceCutoffGain = 1; ///< Upper bound for the combined gain (as factor) assumed when computing the distance beyond which frames are not sent.
+    bool cullNegligibleReceivers = false; ///< Stores if frames are only sent to receivers where they might arrive above negligibleInterferenceLevel.
+    double negligibleInterferenceLevel = 0; ///< Receive power (in mW) below which a frame is not sent to a receiver, if cullNegligibleReceivers is set.
+    long numNegligibleReceivers = 0; ///< Number of receivers a frame was not sent to, as its power would have been negligible.
+    Signal cullingSignal; ///< Scratch signal used (and its memory reused) when checking whether a frame would arrive here below some power level.
     bool recordStats; ///< Stores if tracking of statistics (esp. cOutvectors) is enabled.
     ChannelInfo channelInfo; ///< Channel info keeps track of received AirFrames and provides information about currently active AirFrames at the channel.
+    std::unique_ptr<InterferenceTracker> interferenceTracker; ///< Keeps a running sum of the power of the AirFrames at the channel (if trackInterference is set).
+    std::unique_ptr<LinkBudgetCache> linkBudgetCache; ///< Caches antenna gains and the attenuation of analogueModelsLinkBudget for each sender (if cacheLinkBudget is set).
     std::unique_ptr<Radio> radio; ///< The state machine storing the current radio state (TX, RX, SLEEP).
 
     /**
@@ -139,9 +149,17 @@ protected:
      *
      * These models are not applied immediately, but only attached to the signal.
      * This enables lazy application of the models.
+     * If cacheLinkBudget is set, models which only depend on the link geometry are wrapped in a CachedAnalogueModel.
      */
     AnalogueModelList analogueModelsThresholding;
 
+    /**
+     * The (non-thresholding) analogue models whose attenuation only depends on the link geometry, if cacheLinkBudget is set.
+     *
+     * These models are not applied to every signal, but to the cached link budget of a sender (see linkBudgetCache).
+     */
+    AnalogueModelList analogueModelsLinkBudget;
+
     int upperLayerIn; ///< The id of the in-data gate from the Mac layer.
     int upperLayerOut; ///< The id of the out-data gate to the Mac layer.
     int upperControlOut; ///< The id of the out-control gate to the Mac layer.
@@ -303,6 +321,21 @@ protected:
      */
     void sendMessageDown(AirFrame* pkt);
 
+    /**
+     * Returns the distance beyond which the passed AirFrame arrives below minPowerLevel, even at the lowest pathloss permitted by interferenceCutoffAlpha.
+     *
+     * Returns infinity if interferenceCutoffAlpha is not set.
+     */
+    virtual double calcInterferenceCutoffDistance(const AirFrame* frame) const;
+
+    /**
+     * Returns whether the passed AirFrame would arrive at the receiver below negligibleInterferenceLevel, so it need not be sent there.
+     *
+     * Applies the antenna gains and (lazily) the thresholding analogue models of the receiver to a copy of the frame's signal.
+     * Never culls receivers with analogue models that might increase power, as these give no upper bound for the received power.
+     */
+    bool isNegligibleAt(const cPacket* msg, ChannelAccess* receiver) override;
+
     /**
      * Schedule self message to passed point in time.
      */
@@ -339,6 +372,13 @@ protected:
      */
     virtual void filterSignal(AirFrame* frame);
 
+    /**
+     * Records sender and receiver (this module) in the passed Signal and applies the gains of both antennas.
+     *
+     * If cacheLinkBudget is set, also applies the attenuation of analogueModelsLinkBudget, reusing the link budget cached for the sender if the link geometry is unchanged.
+     */
+    void attachAntennaGains(Signal& signal, const POA& senderPOA);
+
     /**
      * Called when the switching process of the Radio is finished.
      *
@@ -380,6 +420,14 @@ protected:
 public:
     ~BasePhyLayer() override;
 
+    /**
+     * Returns whether the passed AirFrame would arrive at this physical layer below the passed power level (in mW).
+     *
+     * Returns false if this cannot be told without applying analogue models which might increase power.
+     * Called by senders to cull receivers, see isNegligibleAt.
+     */
+    bool arrivesBelow(const AirFrame* frame, double powerLevel);
+
     /** Call the deciders finish method. */
     void finish() override;
 
@@ -429,6 +477,11 @@ public:
      */
     void getChannelInfo(simtime_t_cref from, simtime_t_cref to, AirFrameVector& out) override;
 
+    /**
+     * @brief Returns the InterferenceTracker of this physical layer, or nullptr if trackInterference is not set.
+     */
+    InterferenceTracker* getInterferenceTracker() override;
+
     /**
      * Return noise floor level (in mW).
      */
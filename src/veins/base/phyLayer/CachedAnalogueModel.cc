@@ -0,0 +1,50 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/phyLayer/CachedAnalogueModel.h"
+
+#include "veins/base/toolbox/Signal.h"
+#include "veins/base/utils/POA.h"
+
+using namespace veins;
+
+void CachedAnalogueModel::filterSignal(Signal* signal)
+{
+    const POA senderPoa = signal->getSenderPoa();
+    const POA receiverPoa = signal->getReceiverPoa();
+    const int senderId = senderPoa.pos.getId();
+
+    LinkBudgetCache::Link link;
+    link.senderPosition = senderPoa.pos.getPositionAt();
+    link.senderOrientation = senderPoa.orientation;
+    link.receiverPosition = receiverPoa.pos.getPositionAt();
+    link.receiverOrientation = receiverPoa.orientation;
+    link.generation = model->getLinkGeometryGeneration();
+    if (cache.apply(senderId, link, *signal, simTime())) return;
+
+    // compute the attenuation on its own (without timing), so it can be reused for any further frame over this link
+    Signal attenuation(signal->getSpectrum());
+    attenuation.setSenderPoa(senderPoa);
+    attenuation.setReceiverPoa(receiverPoa);
+    attenuation = 1;
+    model->filterSignal(&attenuation);
+    cache.store(senderId, link, attenuation, simTime());
+    *signal *= attenuation;
+}
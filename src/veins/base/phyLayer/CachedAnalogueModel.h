@@ -0,0 +1,79 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <memory>
+
+#include "veins/veins.h"
+
+#include "veins/base/phyLayer/AnalogueModel.h"
+#include "veins/base/phyLayer/LinkBudgetCache.h"
+
+namespace veins {
+
+/**
+ * @brief Wraps an analogue model whose attenuation only depends on the link geometry, caching its attenuation for each sender.
+ *
+ * Used for thresholding analogue models if BasePhyLayer's cacheLinkBudget parameter is set:
+ * these are still only applied once a signal is checked against a threshold, but the attenuation computed then is reused for further frames over the same link.
+ *
+ * @ingroup analogueModels
+ */
+class VEINS_API CachedAnalogueModel : public AnalogueModel {
+public:
+    CachedAnalogueModel(cComponent* owner, std::unique_ptr<AnalogueModel> model)
+        : AnalogueModel(owner)
+        , model(std::move(model))
+    {
+    }
+
+    /**
+     * @brief Multiplies the signal by the attenuation of the wrapped model, taking it from the cache if the link is unchanged.
+     */
+    void filterSignal(Signal* signal) override;
+
+    bool neverIncreasesPower() override
+    {
+        return model->neverIncreasesPower();
+    }
+
+    bool dependsOnlyOnLinkGeometry() override
+    {
+        return true;
+    }
+
+    unsigned long getLinkGeometryGeneration() override
+    {
+        return model->getLinkGeometryGeneration();
+    }
+
+    /** @brief Returns the cache holding the attenuation of the wrapped model for each sender.*/
+    const LinkBudgetCache& getCache() const
+    {
+        return cache;
+    }
+
+protected:
+    std::unique_ptr<AnalogueModel> model; ///< The wrapped analogue model.
+    LinkBudgetCache cache; ///< Attenuation of the wrapped model for each sender.
+};
+
+} // namespace veins
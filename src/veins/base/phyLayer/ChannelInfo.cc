@@ -24,7 +24,7 @@
 
 #include "veins/base/phyLayer/ChannelInfo.h"
 
-#include <iostream>
+#include <algorithm>
 
 using namespace veins;
 
@@ -32,189 +32,106 @@ using veins::AirFrame;
 
 void ChannelInfo::addAirFrame(AirFrame* frame, simtime_t_cref startTime)
 {
-    ASSERT(airFrameStarts.count(frame) == 0);
-
-    // check if we were previously empty
-    if (isChannelEmpty()) {
-        // earliest time point is current sim time
-        earliestInfoPoint = startTime;
-    }
+    ASSERT(findAirFrame(frame, startTime) == airFrames.end());
 
     // calculate endTime of AirFrame
     simtime_t_cref endTime = startTime + frame->getDuration();
 
-    // add AirFrame to active AirFrames
-    activeAirFrames[endTime].push_back(AirFrameTimePair(startTime, frame));
-
-    // add to start time map
-    airFrameStarts[frame] = startTime;
-
-    ASSERT(!isChannelEmpty());
-}
+    maxDuration = std::max(maxDuration, frame->getDuration());
 
-simtime_t ChannelInfo::findEarliestInfoPoint()
-{
-    // TODO: check for a more efficient way to find out that earliest time-point
-
-    // make a variable for the earliest-start-time of all remaining AirFrames
-    simtime_t earliestStart = SIMTIME_ZERO;
-    AirFrameStartMap::const_iterator it = airFrameStarts.begin();
-
-    // if there is an entry for an AirFrame
-    if (it != airFrameStarts.end()) {
-        // store the start-time of the first entry as earliestStart so far
-        earliestStart = (*it).second;
-
-        // go through all other start-time-points
-        for (; it != airFrameStarts.end(); ++it) {
-            // and check if an earlier start-time was found,
-            // if so, replace earliestStart with it
-            if ((*it).second < earliestStart) earliestStart = (*it).second;
-        }
+    // add AirFrame to active AirFrames, usually by appending (as AirFrames are added chronologically)
+    AirFrameEntry entry{startTime, endTime, frame, true};
+    if (airFrames.empty() || airFrames.back().startTime <= startTime) {
+        airFrames.push_back(entry);
+    }
+    else {
+        auto it = std::upper_bound(airFrames.begin(), airFrames.end(), startTime, [](simtime_t_cref time, const AirFrameEntry& entry) { return time < entry.startTime; });
+        airFrames.insert(it, entry);
     }
 
-    return earliestStart;
+    ASSERT(!isChannelEmpty());
 }
 
-simtime_t ChannelInfo::removeAirFrame(AirFrame* frame)
+simtime_t ChannelInfo::removeAirFrame(AirFrame* frame, simtime_t_cref startTime)
 {
-    ASSERT(airFrameStarts.count(frame) > 0);
+    auto it = findAirFrame(frame, startTime);
+    ASSERT(it != airFrames.end() && it->active);
 
-    // get start of AirFrame
-    simtime_t_cref startTime = airFrameStarts[frame];
+    // move AirFrame to inactive AirFrames
+    it->active = false;
 
-    // calculate end time
-    simtime_t_cref endTime = startTime + frame->getDuration();
-
-    // remove this AirFrame from active AirFrames
-    deleteAirFrame(activeAirFrames, frame, startTime, endTime);
-
-    // add to inactive AirFrames
-    addToInactives(frame, startTime, endTime);
-
-    // Now check, whether the earliest time-point we need to store information
-    // for might have moved on in time, since an AirFrame has been deleted.
-    if (isChannelEmpty()) {
-        earliestInfoPoint = -1;
-    }
-    else {
-        earliestInfoPoint = findEarliestInfoPoint();
-    }
+    // Check if some inactive AirFrames (including this one) can be removed
+    // because the AirFrame to in-activate was the last one they intersected with.
+    simtime_t endTime = it->endTime;
+    checkAndCleanInterval(startTime, endTime);
 
-    return earliestInfoPoint;
+    return getEarliestInfoPoint();
 }
 
 void ChannelInfo::assertNoIntersections()
 {
-    for (AirFrameMatrix::iterator it1 = inactiveAirFrames.begin(); it1 != inactiveAirFrames.end(); ++it1) {
-        simtime_t_cref e0 = it1->first;
-        for (AirFrameTimeList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-            simtime_t_cref s0 = it2->first;
-
-            bool intersects = (recordStartTime > -1 && recordStartTime <= e0);
-
-            for (AirFrameMatrix::iterator it3 = activeAirFrames.begin(); it3 != activeAirFrames.end() && !intersects; ++it3) {
-                simtime_t_cref e1 = it3->first;
-                for (AirFrameTimeList::iterator it4 = it3->second.begin(); it4 != it3->second.end() && !intersects; ++it4) {
-                    simtime_t_cref s1 = it4->first;
-
-                    if (e0 >= s1 && s0 <= e1) intersects = true;
-                }
-            }
-            ASSERT(intersects);
-        }
-    }
-}
+    for (const auto& inactive : airFrames) {
+        if (inactive.active) continue;
+        simtime_t_cref s0 = inactive.startTime;
+        simtime_t_cref e0 = inactive.endTime;
 
-void ChannelInfo::deleteAirFrame(AirFrameMatrix& airFrames, AirFrame* frame, simtime_t_cref startTime, simtime_t_cref endTime)
-{
-    AirFrameMatrix::iterator listIt = airFrames.find(endTime);
-    AirFrameTimeList* list = &listIt->second;
-
-    for (AirFrameTimeList::iterator it = list->begin(); it != list->end(); it++) {
-        if (it->second == frame) {
-            it = list->erase(it);
-            if (list->empty()) {
-                airFrames.erase(listIt);
-            }
-            return;
+        bool intersects = (recordStartTime > -1 && recordStartTime <= e0);
+
+        for (auto it = airFrames.begin(); it != airFrames.end() && !intersects; ++it) {
+            if (!it->active) continue;
+            simtime_t_cref s1 = it->startTime;
+            simtime_t_cref e1 = it->endTime;
+
+            if (e0 >= s1 && s0 <= e1) intersects = true;
         }
+        ASSERT(intersects);
     }
-
-    ASSERT(false);
 }
 
-bool ChannelInfo::canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime)
+bool ChannelInfo::canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime) const
 {
     ASSERT(recordStartTime >= 0 || recordStartTime == -1);
 
     // only if it ends before the point in time we started recording or if
     // we aren't recording at all and it does not intersect with any active one
     // anymore this AirFrame can be deleted
-    return (recordStartTime > endTime || recordStartTime == -1) && !isIntersecting(activeAirFrames, startTime, endTime);
+    return (recordStartTime > endTime || recordStartTime == -1) && !isIntersectingActive(startTime, endTime);
 }
 
 void ChannelInfo::checkAndCleanInterval(simtime_t_cref startTime, simtime_t_cref endTime)
 {
-
-    // get through inactive AirFrame which intersected with the passed interval
-    IntersectionIterator inactiveIntersectIt(&inactiveAirFrames, startTime, endTime);
-
-    AirFrame* inactiveIntersect = inactiveIntersectIt.next();
-    while (inactiveIntersect != nullptr) {
-        simtime_t_cref currentStart = airFrameStarts[inactiveIntersect];
-        simtime_t_cref currentEnd = currentStart + inactiveIntersect->getDuration();
-
-        if (canDiscardInterval(currentStart, currentEnd)) {
-            inactiveIntersectIt.eraseAirFrame();
-
-            airFrameStarts.erase(inactiveIntersect);
-
-            delete inactiveIntersect;
-            inactiveIntersect = nullptr;
+    // first delete every inactive AirFrame which intersected with the passed interval and is not needed anymore,
+    // then remove their entries (so the active entries checked by canDiscardInterval stay in place meanwhile)
+    bool deletedAny = false;
+    for (size_t i = firstPossibleIntersection(startTime) - airFrames.begin(); i < airFrames.size() && airFrames[i].startTime <= endTime; ++i) {
+        AirFrameEntry& entry = airFrames[i];
+        if (entry.active || entry.endTime < startTime) continue;
+
+        if (canDiscardInterval(entry.startTime, entry.endTime)) {
+            delete entry.frame;
+            entry.frame = nullptr;
+            deletedAny = true;
         }
-        inactiveIntersect = inactiveIntersectIt.next();
-    }
-}
-
-void ChannelInfo::addToInactives(AirFrame* frame, simtime_t_cref startTime, simtime_t_cref endTime)
-{
-    // At first, check if some inactive AirFrames can be removed because the
-    // AirFrame to in-activate was the last one they intersected with.
-    checkAndCleanInterval(startTime, endTime);
-
-    if (!canDiscardInterval(startTime, endTime)) {
-        inactiveAirFrames[endTime].push_back(AirFrameTimePair(startTime, frame));
     }
-    else {
-        airFrameStarts.erase(frame);
+    if (!deletedAny) return;
 
-        delete frame;
+    airFrames.erase(std::remove_if(airFrames.begin(), airFrames.end(), [](const AirFrameEntry& entry) { return entry.frame == nullptr; }), airFrames.end());
+    if (airFrames.empty()) {
+        maxDuration = SIMTIME_ZERO;
     }
 }
 
-bool ChannelInfo::isIntersecting(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to) const
+bool ChannelInfo::isIntersectingActive(simtime_t_cref from, simtime_t_cref to) const
 {
-    ConstIntersectionIterator it(&airFrames, from, to);
-    return (it.next() != nullptr);
-}
-
-void ChannelInfo::getIntersections(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to, AirFrameVector& outVector) const
-{
-    ConstIntersectionIterator it(&airFrames, from, to);
-
-    AirFrame* intersect = it.next();
-    while (intersect != nullptr) {
-        outVector.push_back(intersect);
-        intersect = it.next();
+    for (auto it = firstPossibleIntersection(from); it != airFrames.end() && it->startTime <= to; ++it) {
+        if (it->active && it->endTime >= from) return true;
     }
+    return false;
 }
 
 void ChannelInfo::getAirFrames(simtime_t_cref from, simtime_t_cref to, AirFrameVector& out) const
 {
-    // check for intersecting inactive AirFrames
-    getIntersections(inactiveAirFrames, from, to, out);
-
-    // check for intersecting active AirFrames
-    getIntersections(activeAirFrames, from, to, out);
+    for (auto it = firstPossibleIntersection(from); it != airFrames.end() && it->startTime <= to; ++it) {
+        if (it->endTime >= from) out.push_back(it->frame);
+    }
 }
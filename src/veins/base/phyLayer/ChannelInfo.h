@@ -24,7 +24,8 @@
 
 #pragma once
 
-#include <list>
+#include <algorithm>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -65,215 +66,58 @@ namespace veins {
  */
 class VEINS_API ChannelInfo {
 
-protected:
-    /** @brief Type for a pair of an AirFrame and a simulation time.*/
-    typedef std::pair<simtime_t, AirFrame*> AirFrameTimePair;
-    /** @brief Type for a list of AirFrames and a simulation time.*/
-    using AirFrameTimeList = std::list<AirFrameTimePair>;
-    /**
-     * The AirFrames are stored in a Matrix with start- and end time as
-     * dimensions.
-     */
-    typedef std::map<simtime_t, AirFrameTimeList> AirFrameMatrix;
-
+public:
     /**
-     * @brief Iterator for every intersection of a specific interval in a
-     * AirFrameMatrix.
-     *
-     * A time interval A_start to A_end intersects with another interval B_start
-     * to B_end iff the following two conditions are fulfilled:
-     *
-     *         1. A_end >= B_start.
-     *         2. A_start <= B_end and
-     *
-     * Or the defined by the
-     * opposite: The two intervals do not intersect iff A_end < B_start or
-     * A_start > B_end.
-     *
-     * To iterate over a two dimensional (end-time x start-time) container
-     * of AirFrames this class iterates over all AirFrame-lists whose end-time
-     * is bigger or equal than the interval start (intersect condition 1) and in
-     * each of these lists iterates over all entries but only stops at and
-     * returns entries which start-time is smaller or equal than the interval
-     * end (intersection condition 2).
+     * @brief Type for a container of AirFrames.
      *
-     * In template form to work as const- and non-const iterator.
+     * Used as out type for "getAirFrames" method.
      */
-    template <class C, class ItMatrix, class ItList>
-    class VEINS_API BaseIntersectionIterator {
-    public:
-        /** @brief Pointer to the matrix holding the intervals.*/
-        C* intervals;
-
-        /** @brief Point in time to start iterating over intersections.*/
-        simtime_t from;
-
-        /** @brief Point in time to end iterating over intersections.*/
-        simtime_t to;
-
-        /** @brief Iterator over AirFrame end times.*/
-        ItMatrix endIt;
-
-        /** @brief Iterator over AirFrame start times.*/
-        ItList startIt;
-
-        /** @brief True if the we are already pointing to the next entry.*/
-        bool alreadyNext;
-
-    public:
-        /**
-         * @brief Creates an iterator for the specified interval at the
-         * specified AirFrameMatrix.
-         */
-        BaseIntersectionIterator(C* airFrames, simtime_t_cref from, simtime_t_cref to)
-            : intervals(airFrames)
-            , from(from)
-            , to(to)
-        {
-            // begin at the smallest end-time-entry fulfilling the intersection
-            // condition 1
-            endIt = intervals->lower_bound(from);
-
-            if (endIt != intervals->end()) {
-                startIt = endIt->second.begin();
-            }
-            // we are already pointing at the first unchecked interval
-            alreadyNext = true;
-        }
+    using AirFrameVector = std::vector<AirFrame*>;
 
-        /**
-         * @brief Increases the iterator to the next intersecting AirFrame and
-         * returns a pointer to this AirFrame.
-         */
-        AirFrame* next()
-        {
-            if (endIt == intervals->end()) return nullptr;
-
-            // "alreadyNext" indicates that some previous iterator function has
-            // already increased the intern iterators to a yet unchecked values.
-            // This happens after initialization of the iterator and when an
-            // element is erased.
-            if (alreadyNext)
-                alreadyNext = false;
-            else
-                startIt++;
-
-            while (endIt != intervals->end()) {
-                // while there are entries left at the current end-time
-                while (startIt != endIt->second.end()) {
-                    // check if this entry fulfilles the intersection condition
-                    // 2 (condition 1 is already fulfilled in the constructor by
-                    // the start-value of the end-time-iterator)
-                    if (startIt->first <= to) {
-                        return startIt->second;
-                    }
-                    startIt++;
-                }
-
-                endIt++;
-                if (endIt == intervals->end()) return nullptr;
-
-                startIt = endIt->second.begin();
-            }
-
-            return nullptr;
-        }
+protected:
+    /** @brief An AirFrame on the channel, with its start and end time.*/
+    struct AirFrameEntry {
+        simtime_t startTime;
+        simtime_t endTime;
+        AirFrame* frame;
+        /** @brief True if the AirFrame has been added but not yet removed.*/
+        bool active;
     };
 
-    /** @brief Type for a const-iterator over an AirFrame interval matrix.*/
-    typedef BaseIntersectionIterator<const AirFrameMatrix, AirFrameMatrix::const_iterator, AirFrameTimeList::const_iterator> ConstIntersectionIterator;
+    /** @brief Type for a sequence of AirFrame entries.*/
+    using AirFrameEntries = std::vector<AirFrameEntry>;
 
     /**
-     * @brief Type for a iterator over an AirFrame interval matrix.
+     * @brief Stores every active and inactive AirFrame, sorted by start time.
      *
-     * Extends the const-version by an erase method.
-     */
-    class VEINS_API IntersectionIterator : public BaseIntersectionIterator<AirFrameMatrix, AirFrameMatrix::iterator, AirFrameTimeList::iterator> {
-    private:
-        /** @brief Type for shortcut to base class type.*/
-        typedef BaseIntersectionIterator<AirFrameMatrix, AirFrameMatrix::iterator, AirFrameTimeList::iterator> Base;
-
-    public:
-        /**
-         * @brief Creates an iterator for the specified interval at the
-         * specified AirFrameMatrix.
-         */
-        IntersectionIterator(AirFrameMatrix* airFrames, simtime_t_cref from, simtime_t_cref to)
-            : Base(airFrames, from, to)
-        {
-        }
-
-        /**
-         * @brief Erases the AirFrame the iterator currently points to from the
-         * AirFrameMatrix.
-         *
-         * After the erase the iterator points to an invalid value and "next()"
-         * should be called.
-         */
-        void eraseAirFrame()
-        {
-            ASSERT(endIt != intervals->end());
-            ASSERT(startIt != endIt->second.end());
-
-            // erase AirFrame from list
-            startIt = endIt->second.erase(startIt);
-
-            // check if we've deleted the last entry in the list
-            if (startIt == endIt->second.end()) {
-                // check if we deleted the only entry in the list
-                if (endIt->second.empty()) {
-                    intervals->erase(endIt++); // delete list from map
-                }
-                else {
-                    endIt++;
-                }
-
-                // increase to a valid value if we are not done
-                if (endIt != intervals->end()) {
-                    startIt = endIt->second.begin();
-                }
-            }
-            alreadyNext = true;
-        }
-    };
-
-    /**
-     * @brief Stores the currently active AirFrames.
+     * An AirFrame is active if it was added but not yet removed.
+     * An AirFrame is inactive if it has been already removed but still is
+     * needed because it intersects with one or more active AirFrames (or with
+     * the time since recording started).
      *
-     * This means every AirFrame which was added but not yet removed.
+     * As AirFrames are added chronologically, adding one appends to the end.
      */
-    AirFrameMatrix activeAirFrames;
+    AirFrameEntries airFrames;
 
     /**
-     * @brief Stores inactive AirFrames.
+     * @brief Upper bound for the duration of every stored AirFrame.
      *
-     * This means every AirFrame which has been already removed but still is
-     * needed because it intersect with one or more active AirFrames.
+     * A time interval A_start to A_end intersects with another interval B_start
+     * to B_end iff the following two conditions are fulfilled:
+     *
+     *         1. A_end >= B_start.
+     *         2. A_start <= B_end and
+     *
+     * As no AirFrame is longer than maxDuration, only AirFrames starting in
+     * [from - maxDuration, to] can intersect with the interval [from, to], so
+     * intersections are found by a binary search and a scan of this range.
      */
-    AirFrameMatrix inactiveAirFrames;
-
-    /** @brief Type for a map of AirFrame pointers to their start time.*/
-    typedef std::map<AirFrame*, simtime_t> AirFrameStartMap;
-
-    /** @brief Stores the start time of every AirFrame.*/
-    AirFrameStartMap airFrameStarts;
-
-    /** @brief Stores the point in history up to which we have some (but not
-     * necessarily all) channel information stored.*/
-    simtime_t earliestInfoPoint;
+    simtime_t maxDuration;
 
     /** @brief Stores a point in history up to which we need to keep all channel
      * information stored.*/
     simtime_t recordStartTime;
 
-public:
-    /**
-     * @brief Type for a container of AirFrames.
-     *
-     * Used as out type for "getAirFrames" method.
-     */
-    using AirFrameVector = std::list<AirFrame*>;
-
 protected:
     /**
      * @brief Asserts that every inactive AirFrame is still intersecting with at
@@ -282,40 +126,30 @@ protected:
     void assertNoIntersections();
 
     /**
-     * @brief Returns every AirFrame of an AirFrameMatrix which intersect with a
-     * given interval.
-     *
-     * The intersecting AirFrames are stored in the AirFrameVector reference
-     * passed as parameter.
-     */
-    void getIntersections(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to, AirFrameVector& outVector) const;
-
-    /**
-     * @brief Returns true if there is at least one AirFrame in the passed
-     * AirFrameMatrix which intersect with the given interval.
+     * @brief Returns the first AirFrame entry which could intersect with an
+     * interval starting at the passed time (see maxDuration).
      */
-    bool isIntersecting(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to) const;
-
-    /**
-     * @brief Moves a previously active AirFrame to the inactive AirFrames.
-     *
-     * This methods checks if there are some inactive AirFrames which can be
-     * deleted because the AirFrame to in-activate was the last one they
-     * intersected with.
-     * It also checks if the AirFrame to in-activate still intersect with at
-     * least one active AirFrame before it is moved to inactive AirFrames.
-     */
-    void addToInactives(AirFrame* a, simtime_t_cref startTime, simtime_t_cref endTime);
+    AirFrameEntries::const_iterator firstPossibleIntersection(simtime_t_cref from) const
+    {
+        return std::lower_bound(airFrames.begin(), airFrames.end(), from - maxDuration, [](const AirFrameEntry& entry, simtime_t_cref time) { return entry.startTime < time; });
+    }
 
     /**
-     * @brief Deletes an AirFrame from an AirFrameMatrix.
+     * @brief Returns the entry of the passed AirFrame added with the passed
+     * start time, or the end of airFrames if there is none.
      */
-    void deleteAirFrame(AirFrameMatrix& airFrames, AirFrame* a, simtime_t_cref startTime, simtime_t_cref endTime);
+    AirFrameEntries::iterator findAirFrame(const AirFrame* frame, simtime_t_cref startTime)
+    {
+        auto range = std::equal_range(airFrames.begin(), airFrames.end(), AirFrameEntry{startTime, startTime, nullptr, false}, [](const AirFrameEntry& lhs, const AirFrameEntry& rhs) { return lhs.startTime < rhs.startTime; });
+        auto it = std::find_if(range.first, range.second, [frame](const AirFrameEntry& entry) { return entry.frame == frame; });
+        return it != range.second ? it : airFrames.end();
+    }
 
     /**
-     * @brief Returns the start time of the odlest AirFrame on the channel.
+     * @brief Returns true if there is at least one active AirFrame which
+     * intersects with the given interval.
      */
-    simtime_t findEarliestInfoPoint();
+    bool isIntersectingActive(simtime_t_cref from, simtime_t_cref to) const;
 
     /**
      * @brief Checks if any information inside the passed interval can be
@@ -341,7 +175,7 @@ protected:
      * @return returns true if any information for the passed interval can be
      * discarded.
      */
-    bool canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime);
+    bool canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime) const;
 
     /**
      * @brief Checks if any information up from the passed start time can be
@@ -352,16 +186,15 @@ protected:
     void checkAndCleanFrom(simtime_t_cref start)
     {
         // nothing to do
-        if (inactiveAirFrames.empty()) return;
+        if (airFrames.empty()) return;
 
-        // take last ended inactive airframe as end of interval
-        checkAndCleanInterval(start, inactiveAirFrames.rbegin()->first);
+        // no stored AirFrame ends later than this
+        checkAndCleanInterval(start, airFrames.back().startTime + maxDuration);
     }
 
 public:
     ChannelInfo()
-        : earliestInfoPoint(-1)
-        , recordStartTime(-1)
+        : recordStartTime(-1)
     {
     }
 
@@ -384,14 +217,18 @@ public:
      *
      * This does not mean that it loses ownership of the AirFrame.
      *
+     * @param a the AirFrame to remove
+     * @param startTime the time the AirFrame was added with (see addAirFrame)
      * @return The current time-point from on which information concerning
      * AirFrames is needed to be stored.
      */
-    simtime_t removeAirFrame(AirFrame* a);
+    simtime_t removeAirFrame(AirFrame* a, simtime_t_cref startTime);
 
     /**
-     * @brief Fills the passed AirFrameVector reference with the AirFrames which
-     * intersect with the given time interval.
+     * @brief Appends the AirFrames which intersect with the given time interval
+     * to the passed AirFrameVector reference, sorted by start time.
+     *
+     * The passed vector is not cleared, so callers can reuse its memory.
      *
      * Note: Completeness of the list of AirFrames for specific interval can
      * only be assured if start and end point of the interval lies inside the
@@ -403,13 +240,12 @@ public:
 
     /**
      * @brief Returns the current time-point from that information concerning
-     * AirFrames is needed to be stored.
+     * AirFrames is needed to be stored (i.e., the start of the oldest AirFrame
+     * on the channel), or -1 if the channel is empty.
      */
-    simtime_t getEarliestInfoPoint()
+    simtime_t getEarliestInfoPoint() const
     {
-        ASSERT(!isChannelEmpty() || earliestInfoPoint == -1);
-
-        return earliestInfoPoint;
+        return airFrames.empty() ? simtime_t(-1) : airFrames.front().startTime;
     }
 
     /**
@@ -468,9 +304,7 @@ public:
      */
     bool isChannelEmpty() const
     {
-        ASSERT(recordStartTime != -1 || activeAirFrames.empty() == airFrameStarts.empty());
-
-        return airFrameStarts.empty();
+        return airFrames.empty();
     }
 };
 
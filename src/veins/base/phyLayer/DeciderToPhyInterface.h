@@ -35,6 +35,8 @@ class AirFrame;
 
 class BaseWorldUtility;
 
+class InterferenceTracker;
+
 /**
  * See Decider.h for definition of DeciderResult
  */
@@ -60,18 +62,27 @@ public:
      *
      * Used as out-value in "getChannelInfo" method.
      */
-    using AirFrameVector = std::list<AirFrame*>;
+    using AirFrameVector = std::vector<AirFrame*>;
 
     virtual ~DeciderToPhyInterface()
     {
     }
 
     /**
-     * @brief Fills the passed AirFrameVector with all AirFrames that intersect
-     * with the time interval [from, to]
+     * @brief Appends all AirFrames that intersect with the time interval
+     * [from, to] to the passed AirFrameVector, sorted by reception start
      */
     virtual void getChannelInfo(simtime_t_cref from, simtime_t_cref to, AirFrameVector& out) = 0;
 
+    /**
+     * @brief Returns the running sum of the power of all AirFrames on the channel,
+     * or nullptr if the physical layer does not keep one (deciders then need to use getChannelInfo).
+     */
+    virtual InterferenceTracker* getInterferenceTracker()
+    {
+        return nullptr;
+    }
+
     /**
      * @brief Returns a constant which defines the noise floor in
      * the passed time frame (in mW).
@@ -0,0 +1,120 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/phyLayer/InterferenceTracker.h"
+
+#include <algorithm>
+
+#include "veins/base/messages/AirFrame_m.h"
+
+using namespace veins;
+
+void InterferenceTracker::add(AirFrame* frame, simtime_t_cref now)
+{
+    Signal& signal = frame->getSignal();
+    signal.applyAllAnalogueModels();
+
+    if (total.getNumValues() == 0) {
+        total = Signal(signal.getSpectrum());
+    }
+    ASSERT(signal.getSpectrum() == total.getSpectrum());
+
+    const double* values = signal.getValues();
+    double* totalValues = total.getValues();
+    for (size_t i = 0; i < total.getNumValues(); i++) {
+        totalValues[i] += values[i];
+    }
+    frameEnds.emplace(signal.getReceptionEnd(), frame);
+
+    updateWatched(now, true);
+}
+
+void InterferenceTracker::remove(const AirFrame* frame, simtime_t_cref now)
+{
+    auto range = frameEnds.equal_range(frame->getConstSignal().getReceptionEnd());
+    auto it = std::find_if(range.first, range.second, [frame](const std::pair<const simtime_t, const AirFrame*>& entry) { return entry.second == frame; });
+    ASSERT(it != range.second);
+    frameEnds.erase(it);
+
+    double* totalValues = total.getValues();
+    if (frameEnds.empty()) {
+        // start over from exactly zero, so rounding errors do not accumulate
+        std::fill(totalValues, totalValues + total.getNumValues(), 0);
+    }
+    else {
+        const double* values = frame->getConstSignal().getValues();
+        for (size_t i = 0; i < total.getNumValues(); i++) {
+            totalValues[i] = std::max(0.0, totalValues[i] - values[i]);
+        }
+    }
+
+    if (frame == watchedFrame) {
+        watchedFrame = nullptr;
+    }
+    else {
+        updateWatched(now, false);
+    }
+}
+
+double InterferenceTracker::getPowerAt(size_t freqIndex, simtime_t_cref now, const AirFrame* exclude) const
+{
+    if (frameEnds.empty()) return 0;
+    double power = total.at(freqIndex);
+    if (exclude) {
+        power -= exclude->getConstSignal().at(freqIndex);
+    }
+    // frames whose end has not been processed yet
+    for (auto it = frameEnds.begin(); it != frameEnds.end() && it->first <= now; ++it) {
+        if (it->second != exclude) power -= it->second->getConstSignal().at(freqIndex);
+    }
+    return std::max(0.0, power);
+}
+
+void InterferenceTracker::watch(const AirFrame* frame, simtime_t_cref now, simtime_t_cref start, simtime_t_cref end)
+{
+    watchedFrame = frame;
+    watchStart = start;
+    watchEnd = end;
+    maxInterference = Signal(total.getSpectrum());
+    updateWatched(now, true);
+}
+
+const Signal& InterferenceTracker::getMaxInterference(const AirFrame* frame) const
+{
+    ASSERT(frame == watchedFrame);
+    return maxInterference;
+}
+
+void InterferenceTracker::updateWatched(simtime_t_cref now, bool increased)
+{
+    if (!watchedFrame) return;
+
+    // after the start of the interval, the interference can only reach a new maximum when a frame is added
+    const bool beforeStart = now <= watchStart;
+    if (!beforeStart && (!increased || now >= watchEnd)) return;
+
+    double* maxValues = maxInterference.getValues();
+    for (size_t i = 0; i < total.getNumValues(); i++) {
+        // frames ending now do not interfere, even if their end has not been processed yet
+        const double interference = getPowerAt(i, now, watchedFrame);
+        // until the interval starts, only the latest interference counts
+        maxValues[i] = beforeStart ? interference : std::max(maxValues[i], interference);
+    }
+}
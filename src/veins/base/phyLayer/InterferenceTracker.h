@@ -0,0 +1,106 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <map>
+
+#include "veins/veins.h"
+
+#include "veins/base/toolbox/Signal.h"
+
+namespace veins {
+
+class AirFrame;
+
+/**
+ * @brief Keeps a running sum of the power of all AirFrames on the channel of a physical layer.
+ *
+ * Frames are added when they start to arrive and removed when they end, so the total power on the channel (e.g., for clear channel assessment) is available without summing up all frames on the channel.
+ * Additionally, the maximum interference (i.e., the total power of all other frames) one watched frame experiences during an interval of its reception is recorded as frames come and go, so its SINR can be computed without going through all frames that overlapped with it.
+ *
+ * All analogue models are applied to the signal of a frame when it is added (instead of lazily, when needed).
+ *
+ * @see BasePhyLayer::getInterferenceTracker
+ * @ingroup phyLayer
+ */
+class VEINS_API InterferenceTracker {
+public:
+    /**
+     * @brief Adds a frame starting to arrive now, after applying all analogue models to its signal.
+     */
+    void add(AirFrame* frame, simtime_t_cref now);
+
+    /**
+     * @brief Removes a frame whose reception ends now.
+     */
+    void remove(const AirFrame* frame, simtime_t_cref now);
+
+    /** @brief Returns true if no frames are on the channel.*/
+    bool isEmpty() const
+    {
+        return frameEnds.empty();
+    }
+
+    /** @brief Returns the spectrum of the frames on the channel (or an empty one if no frame was ever added).*/
+    const Spectrum& getSpectrum() const
+    {
+        return total.getSpectrum();
+    }
+
+    /**
+     * @brief Returns the total power (in mW) at the passed frequency index of all frames on the channel which have not ended by now,
+     * except for the (optional) excluded frame, which must be on the channel.
+     *
+     * Frames ending now are left out even if their end has not been processed yet.
+     */
+    double getPowerAt(size_t freqIndex, simtime_t_cref now, const AirFrame* exclude = nullptr) const;
+
+    /**
+     * @brief Starts recording (now) the maximum interference a frame which is on the channel experiences during [start, end).
+     *
+     * Only one frame can be watched at a time; this stops watching any other frame.
+     */
+    void watch(const AirFrame* frame, simtime_t_cref now, simtime_t_cref start, simtime_t_cref end);
+
+    /**
+     * @brief Returns the maximum power of all other frames (i.e., the maximum interference) during the interval the passed frame is watched for.
+     */
+    const Signal& getMaxInterference(const AirFrame* frame) const;
+
+private:
+    /** @brief Updates the maximum interference of the watched frame after the total power changed.*/
+    void updateWatched(simtime_t_cref now, bool increased);
+
+    /** @brief Total power of all frames on the channel.*/
+    Signal total;
+
+    /** @brief The frames on the channel, by the end of their reception.*/
+    std::multimap<simtime_t, const AirFrame*> frameEnds;
+
+    const AirFrame* watchedFrame = nullptr;
+    simtime_t watchStart;
+    simtime_t watchEnd;
+
+    /** @brief Maximum interference of the watched frame since watchStart (or the interference right before watchStart).*/
+    Signal maxInterference;
+};
+
+} // namespace veins
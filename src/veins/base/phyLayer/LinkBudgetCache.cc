@@ -0,0 +1,69 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/phyLayer/LinkBudgetCache.h"
+
+#include <algorithm>
+
+using namespace veins;
+
+bool LinkBudgetCache::apply(int senderId, const Link& link, Signal& signal, simtime_t_cref now)
+{
+    auto it = entries.find(senderId);
+    if (it == entries.end() || !(it->second.link == link) || !(it->second.gain.getSpectrum() == signal.getSpectrum())) {
+        numMisses++;
+        return false;
+    }
+
+    numHits++;
+    it->second.lastUsed = now;
+    signal *= it->second.gain;
+    return true;
+}
+
+void LinkBudgetCache::store(int senderId, const Link& link, const Signal& gain, simtime_t_cref now)
+{
+    auto it = entries.find(senderId);
+    if (it == entries.end()) {
+        // discard link budgets not used since the last time this happened, once there are too many
+        if (entries.size() >= sweepSize) {
+            for (auto sweepIt = entries.begin(); sweepIt != entries.end();) {
+                if (sweepIt->second.lastUsed < lastSweep) {
+                    sweepIt = entries.erase(sweepIt);
+                }
+                else {
+                    ++sweepIt;
+                }
+            }
+            lastSweep = now;
+            sweepSize = std::max(sweepSize, 2 * entries.size());
+        }
+        it = entries.emplace(senderId, Entry()).first;
+    }
+
+    Entry& entry = it->second;
+    entry.link = link;
+    // copy only the values, so the cached link budget has no timing
+    if (!(entry.gain.getSpectrum() == gain.getSpectrum())) {
+        entry.gain = Signal(gain.getSpectrum());
+    }
+    std::copy(gain.getValues(), gain.getValues() + gain.getNumValues(), entry.gain.getValues());
+    entry.lastUsed = now;
+}
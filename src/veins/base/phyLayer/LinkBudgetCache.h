@@ -0,0 +1,101 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <unordered_map>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+#include "veins/base/toolbox/Signal.h"
+
+namespace veins {
+
+/**
+ * @brief Caches the link budget (i.e., the product of antenna gains and the attenuation of analogue models which only depend on the link geometry) of each sender at one receiver.
+ *
+ * A cached link budget is reused for further frames from the same sender, as long as the link (see Link) and the spectrum of the frames are unchanged.
+ * Link budgets are stored without timing, so they can be applied to signals of any frame.
+ *
+ * @see BasePhyLayer's cacheLinkBudget parameter
+ * @ingroup phyLayer
+ */
+class VEINS_API LinkBudgetCache {
+public:
+    /** @brief Everything a link budget was computed for, apart from the spectrum.*/
+    struct Link {
+        Coord senderPosition;
+        Coord senderOrientation;
+        Coord receiverPosition;
+        Coord receiverOrientation;
+        unsigned long generation = 0; ///< Sum of AnalogueModel::getLinkGeometryGeneration of the models the link budget includes.
+
+        bool operator==(const Link& other) const
+        {
+            return senderPosition == other.senderPosition && senderOrientation == other.senderOrientation && receiverPosition == other.receiverPosition && receiverOrientation == other.receiverOrientation && generation == other.generation;
+        }
+    };
+
+    /**
+     * @brief Multiplies the passed signal by the link budget cached for the passed sender, if it was computed for the same link and spectrum.
+     *
+     * @return true if the link budget was taken from the cache, false if it needs to be computed (and stored)
+     */
+    bool apply(int senderId, const Link& link, Signal& signal, simtime_t_cref now);
+
+    /**
+     * @brief Caches the passed link budget for frames from the passed sender over the passed link.
+     *
+     * Only the spectrum and values of the passed link budget are stored.
+     */
+    void store(int senderId, const Link& link, const Signal& gain, simtime_t_cref now);
+
+    /** @brief Returns the number of times a link budget was taken from the cache.*/
+    long getNumHits() const
+    {
+        return numHits;
+    }
+
+    /** @brief Returns the number of times a link budget was not cached (and had to be computed).*/
+    long getNumMisses() const
+    {
+        return numMisses;
+    }
+
+private:
+    /** @brief A cached link budget, along with the link it was computed for.*/
+    struct Entry {
+        Link link;
+        Signal gain;
+        simtime_t lastUsed; ///< Time the link budget was last used, to discard those of senders which are gone.
+    };
+
+    /** @brief Cached link budgets, by id of the sender's antenna (see AntennaPosition::getId).*/
+    std::unordered_map<int, Entry> entries;
+
+    size_t sweepSize = 64; ///< Number of cached link budgets above which unused ones are discarded.
+    simtime_t lastSweep; ///< Time unused link budgets were last discarded.
+
+    long numHits = 0;
+    long numMisses = 0;
+};
+
+} // namespace veins
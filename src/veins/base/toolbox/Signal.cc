@@ -24,10 +24,141 @@
 
 #include <sstream>
 
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
 #include "veins/base/phyLayer/AnalogueModel.h"
 
 namespace veins {
 
+namespace {
+
+/*
+ * Element-wise arithmetic on arrays of values, processing four (AVX) or two (SSE2) values at a time where the compiler targets these instruction sets, and remaining values with scalar code.
+ * Each value is computed with a single IEEE operation either way, so results do not depend on the code path taken.
+ */
+
+struct Add {
+    static double apply(double a, double b)
+    {
+        return a + b;
+    }
+#ifdef __AVX__
+    static __m256d apply(__m256d a, __m256d b)
+    {
+        return _mm256_add_pd(a, b);
+    }
+#endif
+#ifdef __SSE2__
+    static __m128d apply(__m128d a, __m128d b)
+    {
+        return _mm_add_pd(a, b);
+    }
+#endif
+};
+
+struct Subtract {
+    static double apply(double a, double b)
+    {
+        return a - b;
+    }
+#ifdef __AVX__
+    static __m256d apply(__m256d a, __m256d b)
+    {
+        return _mm256_sub_pd(a, b);
+    }
+#endif
+#ifdef __SSE2__
+    static __m128d apply(__m128d a, __m128d b)
+    {
+        return _mm_sub_pd(a, b);
+    }
+#endif
+};
+
+struct Multiply {
+    static double apply(double a, double b)
+    {
+        return a * b;
+    }
+#ifdef __AVX__
+    static __m256d apply(__m256d a, __m256d b)
+    {
+        return _mm256_mul_pd(a, b);
+    }
+#endif
+#ifdef __SSE2__
+    static __m128d apply(__m128d a, __m128d b)
+    {
+        return _mm_mul_pd(a, b);
+    }
+#endif
+};
+
+struct Divide {
+    static double apply(double a, double b)
+    {
+        return a / b;
+    }
+#ifdef __AVX__
+    static __m256d apply(__m256d a, __m256d b)
+    {
+        return _mm256_div_pd(a, b);
+    }
+#endif
+#ifdef __SSE2__
+    static __m128d apply(__m128d a, __m128d b)
+    {
+        return _mm_div_pd(a, b);
+    }
+#endif
+};
+
+/** Sets values[i] = Op(values[i], others[i]) for all i < n. */
+template <typename Op>
+void applyElementwise(double* values, const double* others, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX__
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(values + i, Op::apply(_mm256_loadu_pd(values + i), _mm256_loadu_pd(others + i)));
+    }
+#endif
+#ifdef __SSE2__
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(values + i, Op::apply(_mm_loadu_pd(values + i), _mm_loadu_pd(others + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        values[i] = Op::apply(values[i], others[i]);
+    }
+}
+
+/** Sets values[i] = Op(values[i], other) for all i < n. */
+template <typename Op>
+void applyElementwise(double* values, double other, size_t n)
+{
+    size_t i = 0;
+#ifdef __AVX__
+    const __m256d other4 = _mm256_set1_pd(other);
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(values + i, Op::apply(_mm256_loadu_pd(values + i), other4));
+    }
+#endif
+#ifdef __SSE2__
+    const __m128d other2 = _mm_set1_pd(other);
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(values + i, Op::apply(_mm_loadu_pd(values + i), other2));
+    }
+#endif
+    for (; i < n; i++) {
+        values[i] = Op::apply(values[i], other);
+    }
+}
+
+} // namespace
+
 Signal::Signal(const Signal& other)
     : spectrum(other.spectrum)
     , values(other.values)
@@ -92,6 +223,11 @@ double* Signal::getValues()
     return values.data();
 }
 
+const double* Signal::getValues() const
+{
+    return values.data();
+}
+
 size_t Signal::getNumValues() const
 {
     return values.size();
@@ -349,13 +485,13 @@ Signal& Signal::operator+=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::plus<double>());
+    applyElementwise<Add>(values.data(), other.values.data(), values.size());
     return *this;
 }
 
 Signal& Signal::operator+=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other + value; });
+    applyElementwise<Add>(values.data(), value, values.size());
     return *this;
 }
 
@@ -364,13 +500,13 @@ Signal& Signal::operator-=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::minus<double>());
+    applyElementwise<Subtract>(values.data(), other.values.data(), values.size());
     return *this;
 }
 
 Signal& Signal::operator-=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other - value; });
+    applyElementwise<Subtract>(values.data(), value, values.size());
     return *this;
 }
 
@@ -379,13 +515,13 @@ Signal& Signal::operator*=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::multiplies<double>());
+    applyElementwise<Multiply>(values.data(), other.values.data(), values.size());
     return *this;
 }
 
 Signal& Signal::operator*=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other * value; });
+    applyElementwise<Multiply>(values.data(), value, values.size());
     return *this;
 }
 
@@ -394,13 +530,13 @@ Signal& Signal::operator/=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::divides<double>());
+    applyElementwise<Divide>(values.data(), other.values.data(), values.size());
     return *this;
 }
 
 Signal& Signal::operator/=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other / value; });
+    applyElementwise<Divide>(values.data(), value, values.size());
     return *this;
 }
 
@@ -25,6 +25,8 @@
 #include "veins/veins.h"
 
 #include "veins/base/utils/POA.h"
+#include "veins/base/utils/RecyclingPool.h"
+#include "veins/base/utils/SmallVector.h"
 #include "veins/base/utils/Coord.h"
 #include "veins/base/toolbox/Spectrum.h"
 #include "veins/base/phyLayer/AnalogueModel.h"
@@ -110,6 +112,13 @@ public:
      */
     double* getValues();
 
+    /**
+     * Access the underlying power values directly (read-only).
+     *
+     * @see getValues()
+     */
+    const double* getValues() const;
+
     /**
      * Returns the number of power values stored in this signal.
      *
@@ -495,7 +504,13 @@ private:
 
     Spectrum spectrum;
 
-    std::vector<double> values;
+    /**
+     * @brief Power values.
+     *
+     * Stored inline for spectra of up to 16 frequencies (e.g., the 15 used for IEEE 802.11p), so signals can be created and copied without allocating memory.
+     * Values of larger spectra are stored in recycled heap memory.
+     */
+    SmallVector<double, 16, RecyclingAllocator<double, Signal>> values;
 
     size_t numDataValues = 0;
     size_t dataOffset = 0;
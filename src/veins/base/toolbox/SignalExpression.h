@@ -0,0 +1,280 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "veins/veins.h"
+
+#include "veins/base/toolbox/Signal.h"
+
+namespace veins {
+
+/**
+ * Lazily evaluated element-wise arithmetic on Signals.
+ *
+ * Wrapping a Signal with lazy() makes arithmetic operators build an expression instead of computing a temporary Signal for each operation:
+ *
+ * @code
+ * Signal sinr = lazy(signal) / (lazy(interference) + noise);
+ * double minSinr = (lazy(signal) / (lazy(interference) + noise)).getDataMin();
+ * @endcode
+ *
+ * The first line computes all values in one pass when converting the expression to a Signal.
+ * The second line does not create any Signal at all.
+ * Expressions reference the Signals they were built from, so only use them while these Signals exist (i.e., do not store them).
+ *
+ * A Signal computed from an expression copies everything but its values (spectrum, timing, data range, ...) from the leftmost Signal in the expression, like the eager operators of Signal do.
+ *
+ * @see Signal
+ */
+template <typename Derived>
+class SignalExpression {
+public:
+    const Derived& derived() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+
+    /** @brief Computes all values of the expression into a new Signal.*/
+    Signal evaluate() const
+    {
+        const Signal& reference = derived().getSignal();
+        Signal result(reference);
+        double* values = result.getValues();
+        for (size_t i = 0; i < result.getNumValues(); i++) {
+            values[i] = derived()[i];
+        }
+        return result;
+    }
+
+    operator Signal() const
+    {
+        return evaluate();
+    }
+
+    /** @brief Returns the maximum of all values (without computing a Signal).*/
+    double getMax() const
+    {
+        return getMaxInRange(0, derived().getSignal().getNumValues());
+    }
+
+    /** @brief Returns the minimum of the values in the data frequency range (without computing a Signal).*/
+    double getDataMin() const
+    {
+        const Signal& reference = derived().getSignal();
+        return getMinInRange(reference.getDataStart(), reference.getDataEnd());
+    }
+
+    /** @brief Returns the maximum of the values in the data frequency range (without computing a Signal).*/
+    double getDataMax() const
+    {
+        const Signal& reference = derived().getSignal();
+        return getMaxInRange(reference.getDataStart(), reference.getDataEnd());
+    }
+
+private:
+    double getMinInRange(size_t freqIndexLow, size_t freqIndexHigh) const
+    {
+        double result = std::numeric_limits<double>::infinity();
+        for (size_t i = freqIndexLow; i < freqIndexHigh; i++) {
+            result = std::min(result, derived()[i]);
+        }
+        return result;
+    }
+
+    double getMaxInRange(size_t freqIndexLow, size_t freqIndexHigh) const
+    {
+        double result = -std::numeric_limits<double>::infinity();
+        for (size_t i = freqIndexLow; i < freqIndexHigh; i++) {
+            result = std::max(result, derived()[i]);
+        }
+        return result;
+    }
+};
+
+/**
+ * A Signal used in an expression.
+ */
+class VEINS_API SignalTerm : public SignalExpression<SignalTerm> {
+public:
+    explicit SignalTerm(const Signal& signal)
+        : signal(&signal)
+        , values(signal.getValues())
+    {
+    }
+
+    double operator[](size_t index) const
+    {
+        return values[index];
+    }
+
+    const Signal& getSignal() const
+    {
+        return *signal;
+    }
+
+    bool hasSignal() const
+    {
+        return true;
+    }
+
+private:
+    const Signal* signal;
+    const double* values;
+};
+
+/**
+ * A constant used in an expression (i.e., the same value at every frequency).
+ */
+class VEINS_API ConstantTerm {
+public:
+    explicit ConstantTerm(double value)
+        : value(value)
+    {
+    }
+
+    double operator[](size_t) const
+    {
+        return value;
+    }
+
+    const Signal& getSignal() const
+    {
+        throw cRuntimeError("ConstantTerm has no Signal");
+    }
+
+    bool hasSignal() const
+    {
+        return false;
+    }
+
+private:
+    double value;
+};
+
+/**
+ * An element-wise operation (e.g., std::plus<double>) on two expressions, at least one of which contains a Signal.
+ */
+template <typename Op, typename Lhs, typename Rhs>
+class SignalBinaryExpression : public SignalExpression<SignalBinaryExpression<Op, Lhs, Rhs>> {
+public:
+    SignalBinaryExpression(const Lhs& lhs, const Rhs& rhs)
+        : lhs(lhs)
+        , rhs(rhs)
+    {
+        ASSERT(!lhs.hasSignal() || !rhs.hasSignal() || lhs.getSignal().getSpectrum() == rhs.getSignal().getSpectrum());
+    }
+
+    double operator[](size_t index) const
+    {
+        return Op()(lhs[index], rhs[index]);
+    }
+
+    /** @brief Returns the leftmost Signal in this expression.*/
+    const Signal& getSignal() const
+    {
+        return lhs.hasSignal() ? lhs.getSignal() : rhs.getSignal();
+    }
+
+    bool hasSignal() const
+    {
+        return true;
+    }
+
+private:
+    Lhs lhs;
+    Rhs rhs;
+};
+
+/** @brief Starts a lazily evaluated expression, see SignalExpression.*/
+inline SignalTerm lazy(const Signal& signal)
+{
+    return SignalTerm(signal);
+}
+
+/** @brief Maps operands of expressions (Signals, constants and other expressions) to expression types.*/
+template <typename T, typename Enable = void>
+struct SignalExpressionOperand;
+
+template <>
+struct SignalExpressionOperand<Signal> {
+    using type = SignalTerm;
+    static type get(const Signal& signal)
+    {
+        return SignalTerm(signal);
+    }
+};
+
+template <typename T>
+struct SignalExpressionOperand<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    using type = ConstantTerm;
+    static type get(T value)
+    {
+        return ConstantTerm(value);
+    }
+};
+
+template <typename T>
+struct SignalExpressionOperand<T, typename std::enable_if<std::is_base_of<SignalExpression<T>, T>::value>::type> {
+    using type = T;
+    static const T& get(const T& expression)
+    {
+        return expression;
+    }
+};
+
+/** @brief Is true if one of the types is an expression, so arithmetic on them should be lazy (and not use the eager operators of Signal).*/
+template <typename Lhs, typename Rhs>
+struct IsLazySignalArithmetic : std::integral_constant<bool, std::is_base_of<SignalExpression<Lhs>, Lhs>::value || std::is_base_of<SignalExpression<Rhs>, Rhs>::value> {
+};
+
+template <typename Op, typename Lhs, typename Rhs>
+using LazySignalArithmetic = typename std::enable_if<IsLazySignalArithmetic<Lhs, Rhs>::value, SignalBinaryExpression<Op, typename SignalExpressionOperand<Lhs>::type, typename SignalExpressionOperand<Rhs>::type>>::type;
+
+template <typename Lhs, typename Rhs>
+LazySignalArithmetic<std::plus<double>, Lhs, Rhs> operator+(const Lhs& lhs, const Rhs& rhs)
+{
+    return {SignalExpressionOperand<Lhs>::get(lhs), SignalExpressionOperand<Rhs>::get(rhs)};
+}
+
+template <typename Lhs, typename Rhs>
+LazySignalArithmetic<std::minus<double>, Lhs, Rhs> operator-(const Lhs& lhs, const Rhs& rhs)
+{
+    return {SignalExpressionOperand<Lhs>::get(lhs), SignalExpressionOperand<Rhs>::get(rhs)};
+}
+
+template <typename Lhs, typename Rhs>
+LazySignalArithmetic<std::multiplies<double>, Lhs, Rhs> operator*(const Lhs& lhs, const Rhs& rhs)
+{
+    return {SignalExpressionOperand<Lhs>::get(lhs), SignalExpressionOperand<Rhs>::get(rhs)};
+}
+
+template <typename Lhs, typename Rhs>
+LazySignalArithmetic<std::divides<double>, Lhs, Rhs> operator/(const Lhs& lhs, const Rhs& rhs)
+{
+    return {SignalExpressionOperand<Lhs>::get(lhs), SignalExpressionOperand<Rhs>::get(rhs)};
+}
+
+} // namespace veins
@@ -21,6 +21,7 @@
 //
 
 #include "veins/base/toolbox/SignalUtils.h"
+#include "veins/base/toolbox/SignalExpression.h"
 
 #include "veins/base/messages/AirFrame_m.h"
 
@@ -47,7 +48,11 @@ Signal getMaxInterference(simtime_t start, simtime_t end, AirFrame* const refere
     std::priority_queue<Signal, std::vector<Signal>, greaterByReceptionEnd<Signal>> signalEndings;
     simtime_t currentTime = 0;
 
-    interfererFrames.sort([](const AirFrame* x, const AirFrame* y) { return x->getConstSignal().getReceptionStart() < y->getConstSignal().getReceptionStart(); });
+    // frames from ChannelInfo are already sorted
+    auto byReceptionStart = [](const AirFrame* x, const AirFrame* y) { return x->getConstSignal().getReceptionStart() < y->getConstSignal().getReceptionStart(); };
+    if (!std::is_sorted(interfererFrames.begin(), interfererFrames.end(), byReceptionStart)) {
+        std::stable_sort(interfererFrames.begin(), interfererFrames.end(), byReceptionStart);
+    }
 
     for (auto& interfererFrame : interfererFrames) {
         if (interfererFrame->getTreeId() == referenceFrame->getTreeId()) continue; // skip the signal we want to compare to
@@ -149,13 +154,17 @@ double VEINS_API getMinSINR(simtime_t start, simtime_t end, AirFrame* signalFram
     Spectrum spectrum = signal.getSpectrum();
 
     Signal interference = getMaxInterference(start, end, signalFrame, interfererFrames);
-    Signal sinr = signal / (interference + noise);
 
-    double min_sinr = INFINITY;
-    for (uint16_t i = signal.getDataStart(); i < signal.getDataEnd(); i++) {
-        min_sinr = std::min(min_sinr, sinr.at(i));
-    }
-    return min_sinr;
+    // minimum over the data range, without computing the SINR at every frequency first
+    return (lazy(signal) / (lazy(interference) + noise)).getDataMin();
+}
+
+double VEINS_API getMinSINR(AirFrame* signalFrame, const Signal& interference, double noise)
+{
+    Signal& signal = signalFrame->getSignal();
+    signal.applyAllAnalogueModels();
+
+    return (lazy(signal) / (lazy(interference) + noise)).getDataMin();
 }
 
 } // namespace SignalUtils
@@ -65,5 +65,12 @@ bool VEINS_API isChannelPowerBelowThreshold(simtime_t now, AirFrameVector& inter
  */
 double VEINS_API getMinSINR(simtime_t start, simtime_t end, AirFrame* signalFrame, AirFrameVector& interfererFrames, double noise);
 
+/**
+ * @brief Computes the minimum SINR of the signal in its data range, given its (already known) maximum interference.
+ *
+ * @see InterferenceTracker::getMaxInterference
+ */
+double VEINS_API getMinSINR(AirFrame* signalFrame, const Signal& interference, double noise);
+
 } // namespace SignalUtils
 } // namespace veins
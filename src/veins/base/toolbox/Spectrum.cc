@@ -22,6 +22,8 @@
 
 #include "veins/base/toolbox/Spectrum.h"
 
+#include <mutex>
+#include <set>
 #include <sstream>
 
 namespace veins {
@@ -34,47 +36,74 @@ Spectrum::Frequencies normalizeFrequencies(Spectrum::Frequencies freqs)
     return freqs;
 }
 
+namespace {
+
+/**
+ * Returns the interned copy of the passed (normalized) frequencies.
+ */
+const Spectrum::Frequencies* intern(Spectrum::Frequencies freqs)
+{
+    // never destroyed, so spectra stay valid while static objects are destroyed
+    static auto* registry = new std::set<Spectrum::Frequencies>();
+    static auto* registryMutex = new std::mutex();
+
+    std::lock_guard<std::mutex> lock(*registryMutex);
+    return &*registry->insert(std::move(freqs)).first;
+}
+
+} // namespace
+
 Spectrum::Spectrum(Spectrum::Frequencies freqs)
-    : frequencies(normalizeFrequencies(freqs))
+    : frequencies(intern(normalizeFrequencies(std::move(freqs))))
 {
 }
 
+const Spectrum::Frequencies& Spectrum::getFrequencies() const
+{
+    static const Frequencies empty;
+    return frequencies ? *frequencies : empty;
+}
+
 const double& Spectrum::operator[](size_t index) const
 {
-    return frequencies.at(index);
+    return getFrequencies().at(index);
 }
 
 size_t Spectrum::indexOf(double freq) const
 {
+    const Frequencies& freqs = getFrequencies();
+
     // Binary search
-    auto it = std::lower_bound(frequencies.begin(), frequencies.end(), freq);
-    bool found = it != frequencies.end() && (*it) == freq;
+    auto it = std::lower_bound(freqs.begin(), freqs.end(), freq);
+    bool found = it != freqs.end() && (*it) == freq;
 
     ASSERT(found == true);
 
-    return std::distance(frequencies.begin(), it);
+    return std::distance(freqs.begin(), it);
 }
 
 double Spectrum::freqAt(size_t freqIndex) const
 {
-    return frequencies.at(freqIndex);
+    return getFrequencies().at(freqIndex);
 }
 
 size_t Spectrum::getNumFreqs() const
 {
-    return frequencies.size();
+    return getFrequencies().size();
 }
 
 bool operator==(const Spectrum& lhs, const Spectrum& rhs)
 {
-    return lhs.frequencies == rhs.frequencies;
+    // equal frequencies are interned, except for the empty Spectrum
+    if (lhs.frequencies == rhs.frequencies) return true;
+    return lhs.getNumFreqs() == 0 && rhs.getNumFreqs() == 0;
 }
 
 std::ostream& operator<<(std::ostream& os, const Spectrum& s)
 {
     os << "Spectrum(";
     std::ostringstream ss;
-    for (auto&& frequency : s.frequencies) {
+    for (auto&& frequency : s.getFrequencies()) {
         if (ss.tellp() != 0) {
             ss << ", ";
         }
@@ -27,7 +27,6 @@
 #include <algorithm>
 #include <vector>
 #include <iterator>
-#include <memory>
 #include <fstream>
 #include <map>
 
@@ -35,6 +34,12 @@
 
 namespace veins {
 
+/**
+ * The frequencies a Signal is defined on.
+ *
+ * Frequencies are immutable and interned: all spectra with the same frequencies share them, so copying a Spectrum (e.g., along with each copy of an AirFrame) is a pointer copy and comparing spectra is a pointer comparison.
+ * Interned frequencies are kept until the program exits, so only create spectra for a bounded number of distinct frequency sets (e.g., during initialization).
+ */
 class VEINS_API Spectrum {
 public:
     using Frequency = double;
@@ -56,7 +61,9 @@ public:
     friend std::ostream& VEINS_API operator<<(std::ostream& os, const Spectrum& s);
 
 private:
-    Frequencies frequencies;
+    const Frequencies& getFrequencies() const;
+
+    const Frequencies* frequencies = nullptr; ///< interned, shared by all equal spectra; nullptr for the empty Spectrum
 };
 
 } // namespace veins
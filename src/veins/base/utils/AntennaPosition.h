@@ -73,6 +73,15 @@ public:
         return (id == o.id);
     }
 
+    /**
+     * Get the unique identifier of the antenna, as compared by isSameAntenna.
+     */
+    int getId() const
+    {
+        ASSERT(!undef);
+        return id;
+    }
+
 protected:
     int id; /**< unique identifier of antenna returned by ChannelAccess::getId() */
     Coord p; /**< position for linear extrapolation */
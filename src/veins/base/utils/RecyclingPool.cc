@@ -0,0 +1,93 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/utils/RecyclingPool.h"
+
+#include <new>
+
+using namespace veins;
+
+namespace {
+
+std::vector<RecyclingPool*>& pools()
+{
+    // never destroyed, see RecyclingPool
+    static auto* pools = new std::vector<RecyclingPool*>();
+    return *pools;
+}
+
+} // namespace
+
+RecyclingPool::RecyclingPool(std::string name)
+    : name(std::move(name))
+{
+}
+
+RecyclingPool* RecyclingPool::create(const std::type_info& owner)
+{
+    std::string name = omnetpp::opp_typename(owner);
+    const size_t namespaceEnd = name.rfind("::");
+    if (namespaceEnd != std::string::npos) {
+        name = name.substr(namespaceEnd + 2);
+    }
+    auto pool = new RecyclingPool(name);
+    pools().push_back(pool);
+    return pool;
+}
+
+const std::vector<RecyclingPool*>& RecyclingPool::getPools()
+{
+    return pools();
+}
+
+RecyclingPool::FreeList* RecyclingPool::getFreeList(size_t size)
+{
+    for (auto& freeList : freeLists) {
+        if (freeList.blockSize == size) return &freeList;
+    }
+    if (freeLists.size() == maxBlockSizes) return nullptr;
+    freeLists.push_back({size, {}});
+    return &freeLists.back();
+}
+
+void* RecyclingPool::allocate(size_t size)
+{
+    numAllocations++;
+    FreeList* freeList = getFreeList(size);
+    if (freeList && !freeList->blocks.empty()) {
+        numReuses++;
+        void* block = freeList->blocks.back();
+        freeList->blocks.pop_back();
+        return block;
+    }
+    return ::operator new(size);
+}
+
+void RecyclingPool::deallocate(void* block, size_t size)
+{
+    if (!block) return;
+    FreeList* freeList = getFreeList(size);
+    if (freeList) {
+        freeList->blocks.push_back(block);
+    }
+    else {
+        ::operator delete(block);
+    }
+}
@@ -0,0 +1,165 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * @brief Keeps freed memory blocks for reuse instead of returning them to the heap.
+ *
+ * Meant for objects that are allocated and freed at a high rate, e.g., one
+ * per transmitted frame. Blocks are kept in one free list per block size,
+ * so a pool also serves subclasses or buffers of a few different sizes.
+ * Blocks of sizes beyond the first maxBlockSizes ones are taken from and
+ * returned to the heap directly.
+ *
+ * Pools are never destroyed (nor is the memory they keep), so blocks may
+ * still be freed while static objects are destroyed.
+ *
+ * To recycle the instances of a (message) class, define its operator new
+ * and operator delete as allocating from and deallocating to the pool of
+ * the class, e.g., in a targeted cplusplus block of its .msg file.
+ *
+ * @note Not thread-safe: only use for objects created and destroyed by the
+ * simulation thread.
+ *
+ * @see RecyclingAllocator
+ */
+class VEINS_API RecyclingPool {
+public:
+    /** @brief Maximum number of distinct block sizes kept per pool.*/
+    static constexpr size_t maxBlockSizes = 8;
+
+    /**
+     * @brief Returns the pool for the passed type (e.g., the class owning
+     * the recycled memory), creating it on first use.
+     *
+     * The pool is named after the type, without its namespace.
+     */
+    template <typename Owner>
+    static RecyclingPool& get()
+    {
+        static RecyclingPool* pool = create(typeid(Owner));
+        return *pool;
+    }
+
+    /** @brief Returns all pools created so far.*/
+    static const std::vector<RecyclingPool*>& getPools();
+
+    /** @brief Returns a block of size bytes, reusing a freed one if possible.*/
+    void* allocate(size_t size);
+
+    /** @brief Keeps a block of size bytes, as returned by allocate(), for reuse.*/
+    void deallocate(void* block, size_t size);
+
+    const std::string& getName() const
+    {
+        return name;
+    }
+
+    /** @brief Returns the number of blocks handed out since the counters were last reset.*/
+    long getNumAllocations() const
+    {
+        return numAllocations;
+    }
+
+    /** @brief Returns the number of blocks handed out that were freed ones being reused.*/
+    long getNumReuses() const
+    {
+        return numReuses;
+    }
+
+    void resetCounters()
+    {
+        numAllocations = 0;
+        numReuses = 0;
+    }
+
+private:
+    struct FreeList {
+        size_t blockSize;
+        std::vector<void*> blocks;
+    };
+
+    explicit RecyclingPool(std::string name);
+
+    static RecyclingPool* create(const std::type_info& owner);
+
+    /** @brief Returns the free list for blocks of size bytes, or nullptr if there are too many distinct sizes already.*/
+    FreeList* getFreeList(size_t size);
+
+    std::string name;
+    std::vector<FreeList> freeLists;
+    long numAllocations = 0;
+    long numReuses = 0;
+};
+
+/**
+ * @brief Allocator for standard containers taking memory from the
+ * RecyclingPool of the type Owner (e.g., the class owning the container).
+ */
+template <typename T, typename Owner>
+class RecyclingAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = RecyclingAllocator<U, Owner>;
+    };
+
+    RecyclingAllocator() = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U, Owner>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(RecyclingPool::get<Owner>().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        RecyclingPool::get<Owner>().deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const RecyclingAllocator<U, Owner>&) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const RecyclingAllocator<U, Owner>&) const
+    {
+        return false;
+    }
+};
+
+} // namespace veins
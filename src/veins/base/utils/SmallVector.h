@@ -0,0 +1,180 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * @brief Fixed-size array of values stored inline for up to N elements,
+ * falling back to heap memory (from Allocator) for larger sizes.
+ *
+ * Only supports what Signal needs: the size is set on construction or
+ * assignment and does not change otherwise.
+ *
+ * @tparam T a trivially copyable type (e.g., double)
+ */
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only supports trivially copyable types");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(size_t count, const T& value)
+    {
+        assign(count, value);
+    }
+
+    SmallVector(const SmallVector& other)
+    {
+        *this = other;
+    }
+
+    SmallVector(SmallVector&& other)
+    {
+        *this = std::move(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this == &other) return *this;
+        if (other.isInline()) {
+            heapValues.clear();
+            std::copy(other.begin(), other.end(), inlineValues.begin());
+        }
+        else {
+            heapValues = other.heapValues;
+        }
+        count = other.count;
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other)
+    {
+        if (this == &other) return *this;
+        if (other.isInline()) {
+            heapValues.clear();
+            std::copy(other.begin(), other.end(), inlineValues.begin());
+        }
+        else {
+            heapValues = std::move(other.heapValues);
+        }
+        count = other.count;
+        other.heapValues.clear();
+        other.count = 0;
+        return *this;
+    }
+
+    /** @brief Replaces the contents with count copies of value.*/
+    void assign(size_t newCount, const T& value)
+    {
+        if (newCount <= N) {
+            heapValues.clear();
+            std::fill(inlineValues.begin(), inlineValues.begin() + newCount, value);
+        }
+        else {
+            heapValues.assign(newCount, value);
+        }
+        count = newCount;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    T* data()
+    {
+        return isInline() ? inlineValues.data() : heapValues.data();
+    }
+
+    const T* data() const
+    {
+        return isInline() ? inlineValues.data() : heapValues.data();
+    }
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + count;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + count;
+    }
+
+    T& operator[](size_t index)
+    {
+        return data()[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return data()[index];
+    }
+
+    T& at(size_t index)
+    {
+        if (index >= count) throw std::out_of_range("SmallVector index out of range");
+        return data()[index];
+    }
+
+    const T& at(size_t index) const
+    {
+        if (index >= count) throw std::out_of_range("SmallVector index out of range");
+        return data()[index];
+    }
+
+    /** @brief Returns true if the values are stored inline (i.e., there are no more than N of them).*/
+    bool isInline() const
+    {
+        return count <= N;
+    }
+
+private:
+    std::array<T, N> inlineValues;
+    std::vector<T, Allocator> heapValues;
+    size_t count = 0;
+};
+
+} // namespace veins
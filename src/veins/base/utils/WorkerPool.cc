@@ -0,0 +1,86 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/utils/WorkerPool.h"
+
+#include <algorithm>
+
+using namespace veins;
+
+WorkerPool::WorkerPool(unsigned int numThreads)
+{
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskStarted.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(const std::function<void()>& task, size_t maxThreads)
+{
+    const size_t numHelpers = std::min(threads.size(), std::max<size_t>(maxThreads, 1) - 1);
+    if (numHelpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->task = &task;
+            numWanted = numHelpers;
+            numRunning = numHelpers;
+            ++generation;
+        }
+        taskStarted.notify_all();
+    }
+
+    task();
+
+    if (numHelpers > 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        taskFinished.wait(lock, [this]() { return numRunning == 0; });
+        this->task = nullptr;
+    }
+}
+
+void WorkerPool::work()
+{
+    unsigned long lastGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskStarted.wait(lock, [this, lastGeneration]() { return stopping || (generation != lastGeneration && numWanted > 0); });
+        if (stopping) return;
+        lastGeneration = generation;
+        --numWanted;
+        const std::function<void()>* currentTask = task;
+
+        lock.unlock();
+        (*currentTask)();
+        lock.lock();
+
+        if (--numRunning == 0) taskFinished.notify_one();
+    }
+}
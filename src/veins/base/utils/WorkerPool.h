@@ -0,0 +1,82 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * @brief Threads which are started once and then run tasks on request, so running a task does not need to start and join threads.
+ *
+ * Tasks are run by the calling thread together with (some of) the pooled threads, e.g., each taking work items from a shared atomic counter until none are left.
+ * Tasks must not throw exceptions.
+ *
+ * @note Only one thread (e.g., the simulation's) may call run().
+ */
+class VEINS_API WorkerPool {
+public:
+    /**
+     * @brief Starts numThreads - 1 threads, so tasks can be run on up to numThreads threads (including the calling one).
+     */
+    explicit WorkerPool(unsigned int numThreads);
+
+    /**
+     * @brief Stops and joins all threads.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Runs task on the calling thread and on up to maxThreads - 1 pooled threads, returning when it has finished on all of them.
+     */
+    void run(const std::function<void()>& task, size_t maxThreads);
+
+    /** @brief Returns the number of threads tasks can be run on (including the calling one).*/
+    unsigned int getNumThreads() const
+    {
+        return threads.size() + 1;
+    }
+
+private:
+    /** @brief Waits for tasks and runs them, until the pool is stopped.*/
+    void work();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable taskStarted; ///< Notified when a task is started (or the pool is stopped).
+    std::condition_variable taskFinished; ///< Notified when the last pooled thread finished a task.
+    const std::function<void()>* task = nullptr; ///< The task being run.
+    unsigned long generation = 0; ///< Number of tasks started so far, so no thread runs a task twice.
+    size_t numWanted = 0; ///< Number of pooled threads still to join the current task.
+    size_t numRunning = 0; ///< Number of pooled threads which have not finished the current task yet.
+    bool stopping = false;
+};
+
+} // namespace veins
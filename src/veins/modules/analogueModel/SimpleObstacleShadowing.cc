@@ -40,7 +40,11 @@ void SimpleObstacleShadowing::filterSignal(Signal* signal)
     auto senderPos = signal->getSenderPoa().pos.getPositionAt();
     auto receiverPos = signal->getReceiverPoa().pos.getPositionAt();
 
-    double factor = obstacleControl.calculateAttenuation(senderPos, receiverPos);
+    // transmissions to or from static antennas can use precomputed attenuation
+    double factor;
+    if (!obstacleControl.lookupStaticAttenuation(signal->getSenderPoa().pos.getId(), receiverPos, factor) && !obstacleControl.lookupStaticAttenuation(signal->getReceiverPoa().pos.getId(), senderPos, factor)) {
+        factor = obstacleControl.calculateAttenuation(senderPos, receiverPos);
+    }
 
     EV_TRACE << "value is: " << factor << endl;
 
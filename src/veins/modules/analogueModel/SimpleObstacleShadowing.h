@@ -78,6 +78,16 @@ public:
     {
         return true;
     }
+
+    bool dependsOnlyOnLinkGeometry() override
+    {
+        return true;
+    }
+
+    unsigned long getLinkGeometryGeneration() override
+    {
+        return obstacleControl.getGeneration();
+    }
 };
 
 } // namespace veins
@@ -95,6 +95,11 @@ public:
     {
         return true;
     }
+
+    bool dependsOnlyOnLinkGeometry() override
+    {
+        return true;
+    }
 };
 
 } // namespace veins
@@ -57,6 +57,11 @@ public:
 
     void filterSignal(Signal* signal) override;
 
+    bool dependsOnlyOnLinkGeometry() override
+    {
+        return true;
+    }
+
 protected:
     /** @brief stores the dielectric constant used for calculation */
     double epsilon_r;
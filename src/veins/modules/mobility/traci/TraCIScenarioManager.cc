@@ -572,6 +572,13 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
     mod->callInitialize();
     hosts[nodeId] = mod;
 
+    for (auto ca : getSubmodulesOfType<ChannelAccess>(mod, true)) {
+        auto connectionManager = ChannelAccess::getConnectionManager(ca->getParentModule());
+        if (connectionManager->usesBatchPosUpdates() && std::find(batchingConnectionManagers.begin(), batchingConnectionManagers.end(), connectionManager) == batchingConnectionManagers.end()) {
+            batchingConnectionManagers.push_back(connectionManager);
+        }
+    }
+
     // post-initialize TraCIMobility
     auto mobilityModules = getSubmodulesOfType<TraCIMobility>(mod);
     for (auto mm : mobilityModules) {
@@ -654,6 +661,11 @@ void TraCIScenarioManager::executeOneTimestep()
         }
     }
 
+    // update connections of all nics moved during this timestep at once
+    for (auto connectionManager : batchingConnectionManagers) {
+        connectionManager->flushNicPosUpdates();
+    }
+
     emit(traciTimestepEndSignal, targetTime);
 
     if (!autoShutdownTriggered) scheduleAt(simTime() + updateInterval, executeOneTimestepTrigger);
@@ -26,6 +26,7 @@
 #include <memory>
 #include <list>
 #include <queue>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -170,6 +171,7 @@ protected:
     BaseWorldUtility* world;
     std::map<const BaseMobility*, const MobileHostObstacle*> vehicleObstacles;
     VehicleObstacleControl* vehicleObstacleControl;
+    std::vector<BaseConnectionManager*> batchingConnectionManagers; /**< connection managers of managed nics that batch position updates (in the order they were first seen), flushed after each timestep */
 
     void executeOneTimestep(); /**< read and execute all commands for the next timestep */
 
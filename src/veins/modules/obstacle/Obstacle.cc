@@ -21,6 +21,8 @@
 //
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "veins/modules/obstacle/Obstacle.h"
 
@@ -30,18 +32,21 @@ using veins::Obstacle;
 
 Obstacle::Obstacle(std::string id, std::string type, double attenuationPerCut, double attenuationPerMeter)
     : visualRepresentation(nullptr)
+    , queryIndex(0)
     , id(id)
     , type(type)
     , attenuationPerCut(attenuationPerCut)
     , attenuationPerMeter(attenuationPerMeter)
+    , bboxP1(0, 0, -std::numeric_limits<double>::infinity())
+    , bboxP2(0, 0, std::numeric_limits<double>::infinity())
 {
 }
 
 void Obstacle::setShape(Coords shape)
 {
     coords = shape;
-    bboxP1 = Coord(1e7, 1e7);
-    bboxP2 = Coord(-1e7, -1e7);
+    bboxP1 = Coord(1e7, 1e7, bboxP1.z);
+    bboxP2 = Coord(-1e7, -1e7, bboxP2.z);
     for (Coords::const_iterator i = coords.begin(); i != coords.end(); ++i) {
         bboxP1.x = std::min(i->x, bboxP1.x);
         bboxP1.y = std::min(i->y, bboxP1.y);
@@ -50,11 +55,35 @@ void Obstacle::setShape(Coords shape)
     }
 }
 
+void Obstacle::setShape(Coords shape, const Coord& bboxMin, const Coord& bboxMax)
+{
+    coords = std::move(shape);
+    bboxP1 = Coord(bboxMin.x, bboxMin.y, bboxP1.z);
+    bboxP2 = Coord(bboxMax.x, bboxMax.y, bboxP2.z);
+}
+
 const Obstacle::Coords& Obstacle::getShape() const
 {
     return coords;
 }
 
+void Obstacle::setHeight(double height, double base)
+{
+    ASSERT(height >= 0);
+    bboxP1.z = base;
+    bboxP2.z = base + height;
+}
+
+double Obstacle::getBase() const
+{
+    return bboxP1.z;
+}
+
+double Obstacle::getTop() const
+{
+    return bboxP2.z;
+}
+
 const Coord Obstacle::getBboxP1() const
 {
     return bboxP1;
@@ -66,6 +95,12 @@ const Coord Obstacle::getBboxP2() const
 }
 
 bool Obstacle::containsPoint(Coord point) const
+{
+    if (point.z < bboxP1.z || point.z > bboxP2.z) return false;
+    return shapeContainsPoint(point);
+}
+
+bool Obstacle::shapeContainsPoint(const Coord& point) const
 {
     bool isInside = false;
     const Obstacle::Coords& shape = getShape();
@@ -105,9 +140,13 @@ double segmentsIntersectAt(const Coord& p1From, const Coord& p1To, const Coord&
 }
 } // namespace
 
-std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
+size_t Obstacle::findIntersections(const Coord& senderPos, const Coord& receiverPos, double* intersectAt, size_t capacity) const
 {
-    std::vector<double> intersectAt;
+    size_t numIntersections = 0;
+    auto add = [&](double i) {
+        if (numIntersections < capacity) intersectAt[numIntersections] = i;
+        ++numIntersections;
+    };
     const Obstacle::Coords& shape = getShape();
     Obstacle::Coords::const_iterator i = shape.begin();
     Obstacle::Coords::const_iterator j = (shape.rbegin() + 1).base();
@@ -117,13 +156,70 @@ std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coo
 
         double i = segmentsIntersectAt(senderPos, receiverPos, c1, c2);
         if (i != -1) {
-            intersectAt.push_back(i);
+            // only count walls crossed between base and top
+            double z = senderPos.z + i * (receiverPos.z - senderPos.z);
+            if (z < bboxP1.z || z > bboxP2.z) continue;
+            add(i);
         }
     }
+    // also count crossings of floor and roof
+    if (senderPos.z != receiverPos.z) {
+        for (double z : {bboxP1.z, bboxP2.z}) {
+            if (std::isinf(z)) continue;
+            double i = (z - senderPos.z) / (receiverPos.z - senderPos.z);
+            if (i <= 0 || i >= 1) continue;
+            if (!shapeContainsPoint(senderPos + (receiverPos - senderPos) * i)) continue;
+            add(i);
+        }
+    }
+    return numIntersections;
+}
+
+std::vector<double> Obstacle::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
+{
+    // every wall, the floor, and the roof are crossed at most once
+    std::vector<double> intersectAt(coords.size() + 2);
+    intersectAt.resize(findIntersections(senderPos, receiverPos, intersectAt.data(), intersectAt.size()));
     std::sort(intersectAt.begin(), intersectAt.end());
     return intersectAt;
 }
 
+bool Obstacle::getCrossings(const Coord& senderPos, const Coord& receiverPos, size_t& numCuts, double& fractionInObstacle) const
+{
+    double inlineIntersections[maxInlineIntersections];
+    std::vector<double> manyIntersections;
+    double* intersectAt = inlineIntersections;
+    numCuts = findIntersections(senderPos, receiverPos, inlineIntersections, maxInlineIntersections);
+    if (numCuts > maxInlineIntersections) {
+        manyIntersections = getIntersections(senderPos, receiverPos);
+        intersectAt = manyIntersections.data();
+    }
+    else {
+        std::sort(intersectAt, intersectAt + numCuts);
+    }
+
+    bool senderInside = containsPoint(senderPos);
+    bool receiverInside = containsPoint(receiverPos);
+    if ((numCuts == 0) && !senderInside && !receiverInside) return false;
+
+    // intersections alternate between entering and leaving the obstacle, so sum up the distances between leaving and the last entering
+    fractionInObstacle = 0;
+    bool inside = senderInside;
+    double enteredAt = 0;
+    for (size_t i = 0; i < numCuts; ++i) {
+        if (inside) {
+            fractionInObstacle += intersectAt[i] - enteredAt;
+        }
+        else {
+            enteredAt = intersectAt[i];
+        }
+        inside = !inside;
+    }
+    ASSERT(inside == receiverInside);
+    if (inside) fractionInObstacle += 1 - enteredAt;
+    return true;
+}
+
 std::string Obstacle::getType() const
 {
     return type;
@@ -33,6 +33,9 @@ namespace veins {
 
 /**
  * stores information about an Obstacle for ObstacleControl
+ *
+ * An Obstacle is a polygon in the x-y plane, extruded from z = getBase() to z = getTop().
+ * Unless setHeight has been called, it extends infinitely in both directions, i.e., it blocks transmissions crossing its shape no matter how high sender and receiver are.
  */
 class VEINS_API Obstacle {
 public:
@@ -41,7 +44,17 @@ public:
     Obstacle(std::string id, std::string type, double attenuationPerCut, double attenuationPerMeter);
 
     void setShape(Coords shape);
+    /**
+     * set shape along with its (precomputed) bounding box, which must be the smallest one containing all points of shape
+     */
+    void setShape(Coords shape, const Coord& bboxMin, const Coord& bboxMax);
     const Coords& getShape() const;
+    /**
+     * set vertical extent of the obstacle to reach from z = base to z = base + height
+     */
+    void setHeight(double height, double base = 0);
+    double getBase() const;
+    double getTop() const;
     const Coord getBboxP1() const;
     const Coord getBboxP2() const;
     bool containsPoint(Coord Point) const;
@@ -52,20 +65,41 @@ public:
     double getAttenuationPerMeter() const;
 
     /**
-     * get a list of points (in [0, 1]) along the line between sender and receiver where the beam intersects with this obstacle
+     * get a list of points (in [0, 1]) along the line between sender and receiver where the beam intersects with this obstacle (its walls, floor, or roof)
      */
     std::vector<double> getIntersections(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * get the number of times the beam between sender and receiver crosses this obstacle (its walls, floor, or roof) as well as the fraction of the beam (in [0, 1]) that runs through its interior
+     *
+     * Same as evaluating getIntersections and containsPoint, but without allocating memory (unless the beam crosses more than maxInlineIntersections walls).
+     * return false if the beam neither crosses the obstacle nor starts or ends inside of it
+     */
+    bool getCrossings(const Coord& senderPos, const Coord& receiverPos, size_t& numCuts, double& fractionInObstacle) const;
+
     AnnotationManager::Annotation* visualRepresentation;
+    size_t queryIndex; /**< index unique among all obstacles of an ObstacleControl, used to mark obstacles already visited by a query */
 
 protected:
     std::string id;
     std::string type;
     double attenuationPerCut; /**< in dB. attenuation per exterior border of obstacle */
     double attenuationPerMeter; /**< in dB / m. to account for attenuation caused by interior of obstacle */
+    /**
+     * return whether point is inside the shape when looking from above, i.e., ignoring its z coordinate
+     */
+    bool shapeContainsPoint(const Coord& point) const;
+
+    /**
+     * write the (unsorted) points getIntersections would return to intersectAt, as far as capacity allows; return how many points there are
+     */
+    size_t findIntersections(const Coord& senderPos, const Coord& receiverPos, double* intersectAt, size_t capacity) const;
+
+    static constexpr size_t maxInlineIntersections = 32; /**< getCrossings keeps up to this many points on the stack */
+
     Coords coords;
-    Coord bboxP1;
-    Coord bboxP2;
+    Coord bboxP1; /**< corner of bounding box with smallest coordinates, z is the base of the obstacle */
+    Coord bboxP2; /**< corner of bounding box with largest coordinates, z is the top of the obstacle */
 };
 
 } // namespace veins
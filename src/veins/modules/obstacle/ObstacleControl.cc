@@ -20,11 +20,16 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <atomic>
+#include <cmath>
+#include <fstream>
 #include <sstream>
 #include <map>
 #include <set>
+#include <thread>
 
 #include "veins/modules/obstacle/ObstacleControl.h"
+#include "veins/modules/obstacle/ObstacleFile.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 
 using veins::ObstacleControl;
@@ -33,14 +38,33 @@ Define_Module(veins::ObstacleControl);
 
 namespace {
 
-veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize = 250)
+std::vector<veins::Obstacle*> getObstaclePointers(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner)
 {
     std::vector<veins::Obstacle*> obstaclePointers;
     obstaclePointers.reserve(obstacleOwner.size());
     std::transform(obstacleOwner.begin(), obstacleOwner.end(), std::back_inserter(obstaclePointers), [](const std::unique_ptr<veins::Obstacle>& obstacle) { return obstacle.get(); });
+    return obstaclePointers;
+}
+
+veins::BBoxLookup::Box getBBox(veins::Obstacle* o)
+{
+    return veins::BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}};
+}
+
+veins::BBoxLookup::ZRange getZRange(veins::Obstacle* o)
+{
+    return veins::BBoxLookup::ZRange{o->getBase(), o->getTop()};
+}
+
+veins::BBoxLookup rebuildBBoxLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner, int gridCellSize = 250, veins::BBoxLookup::Layout layout = veins::BBoxLookup::Layout::arrayOfStructs)
+{
     auto playgroundSize = veins::FindModule<veins::BaseWorldUtility*>::findGlobalModule()->getPgs();
-    auto bboxFunction = [](veins::Obstacle* o) { return veins::BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}}; };
-    return veins::BBoxLookup(obstaclePointers, bboxFunction, playgroundSize->x, playgroundSize->y, gridCellSize);
+    return veins::BBoxLookup(getObstaclePointers(obstacleOwner), getBBox, playgroundSize->x, playgroundSize->y, gridCellSize, layout, getZRange);
+}
+
+veins::BVHLookup rebuildBVHLookup(const std::vector<std::unique_ptr<veins::Obstacle>>& obstacleOwner)
+{
+    return veins::BVHLookup(getObstaclePointers(obstacleOwner), getBBox, getZRange);
 }
 
 } // anonymous namespace
@@ -53,24 +77,82 @@ void ObstacleControl::initialize(int stage)
 {
     if (stage == 1) {
         obstacleOwner.clear();
+        numQueryIndices = 0;
+        freeQueryIndices.clear();
         cacheEntries.clear();
+        cacheIndex.clear();
         isBboxLookupDirty = true;
 
         annotations = AnnotationManagerAccess().getIfExists();
         if (annotations) annotationGroup = annotations->createGroup("obstacles");
 
         obstaclesXml = par("obstacles");
+        std::string obstacleIndexName = par("obstacleIndex").stdstringValue();
+        if (obstacleIndexName == "grid") {
+            obstacleIndex = ObstacleIndex::grid;
+        }
+        else if (obstacleIndexName == "bvh") {
+            obstacleIndex = ObstacleIndex::bvh;
+        }
+        else {
+            throw cRuntimeError("obstacleIndex was \"%s\", but must be \"grid\" or \"bvh\"", obstacleIndexName.c_str());
+        }
         gridCellSize = par("gridCellSize");
         if (gridCellSize < 1) {
             throw cRuntimeError("gridCellSize was %d, but must be a positive integer number", gridCellSize);
         }
+        bboxLayout = par("structOfArraysLookup").boolValue() ? BBoxLookup::Layout::structOfArrays : BBoxLookup::Layout::arrayOfStructs;
+        int cacheSizePar = par("cacheSize");
+        if (cacheSizePar < 0) {
+            throw cRuntimeError("cacheSize was %d, but must not be negative", cacheSizePar);
+        }
+        cacheSize = cacheSizePar;
+        cacheIndex.reserve(cacheSize);
+        cacheResolution = par("cacheResolution");
+        if (cacheResolution < 0) {
+            throw cRuntimeError("cacheResolution was %f, but must not be negative", cacheResolution);
+        }
+        cacheHits = 0;
+        cacheMisses = 0;
+        cacheEvictions = 0;
+        rasterRadius = par("rasterRadius");
+        if (rasterRadius < 0) {
+            throw cRuntimeError("rasterRadius was %f, but must not be negative", rasterRadius);
+        }
+        rasterResolution = par("rasterResolution");
+        if (rasterResolution <= 0) {
+            throw cRuntimeError("rasterResolution was %f, but must be positive", rasterResolution);
+        }
+        rasterHeight = par("rasterHeight");
+        int rasterThreadsPar = par("rasterThreads");
+        if (rasterThreadsPar < 0) {
+            throw cRuntimeError("rasterThreads was %d, but must not be negative", rasterThreadsPar);
+        }
+        rasterThreads = (rasterThreadsPar > 0) ? rasterThreadsPar : std::max(1u, std::thread::hardware_concurrency());
+        rasterDirectory = par("rasterDirectory").stdstringValue();
+        rasterHits = 0;
+        rasterMisses = 0;
 
         addFromXml(obstaclesXml);
+        std::string obstaclesFile = par("obstaclesFile").stdstringValue();
+        if (!obstaclesFile.empty()) addFromFile(obstaclesFile);
+        if (par("buildIndexEagerly").boolValue()) updateLookup();
+    }
+    else if (stage == 2) {
+        // static antennas have registered in stage 1, build their rasters for the obstacles loaded so far
+        // (rasters that are affected by obstacles added later are rebuilt on next use)
+        if (rasterRadius > 0 && areRastersDirty && obstacleOwner.size() > 0) buildRasters();
     }
 }
 
 void ObstacleControl::finish()
 {
+    recordScalar("AttenuationCacheHits", cacheHits);
+    recordScalar("AttenuationCacheMisses", cacheMisses);
+    recordScalar("AttenuationCacheEvictions", cacheEvictions);
+    recordScalar("AttenuationRasterHits", rasterHits);
+    recordScalar("AttenuationRasterMisses", rasterMisses);
+
     obstacleOwner.clear();
 }
 
@@ -118,7 +200,8 @@ void ObstacleControl::addFromXml(cXMLElement* xml)
         }
         else if (tag == "poly") {
 
-            // <poly id="building#0" type="building" color="#F00" shape="16,0 8,13.8564 -8,13.8564 -16,0 -8,-13.8564 8,-13.8564" />
+            // <poly id="building#0" type="building" color="#F00" shape="16,0 8,13.8564 -8,13.8564 -16,0 -8,-13.8564 8,-13.8564" height="20" base="0" />
+            // (height and base are optional; without height, the obstacle blocks transmissions at any height)
             ASSERT(e->getAttribute("id"));
             std::string id = e->getAttribute("id");
             ASSERT(e->getAttribute("type"));
@@ -138,6 +221,17 @@ void ObstacleControl::addFromXml(cXMLElement* xml)
                 sh.push_back(Coord(xya[0], xya[1]));
             }
             obs.setShape(sh);
+            if (e->getAttribute("height")) {
+                double height = strtod(e->getAttribute("height"), nullptr);
+                double base = e->getAttribute("base") ? strtod(e->getAttribute("base"), nullptr) : 0;
+                if (height < 0) {
+                    throw cRuntimeError("Obstacle \"%s\" has negative height %f", id.c_str(), height);
+                }
+                obs.setHeight(height, base);
+            }
+            else if (e->getAttribute("base")) {
+                throw cRuntimeError("Obstacle \"%s\" has a base but no height", id.c_str());
+            }
             add(obs);
         }
         else {
@@ -146,6 +240,45 @@ void ObstacleControl::addFromXml(cXMLElement* xml)
     }
 }
 
+void ObstacleControl::addFromFile(std::string fileName)
+{
+    ObstacleFile file(fileName);
+    const ObstacleFile::Header& header = file.getHeader();
+
+    std::vector<std::string> typeIds;
+    typeIds.reserve(header.numTypes);
+    for (uint64_t i = 0; i < header.numTypes; ++i) {
+        const ObstacleFile::Type& type = file.getType(i);
+        std::string id = file.getString(type.idOffset, type.idLength);
+        perCut[id] = type.attenuationPerCut;
+        perMeter[id] = type.attenuationPerMeter;
+        typeIds.push_back(id);
+    }
+
+    obstacleOwner.reserve(obstacleOwner.size() + header.numObstacles);
+    for (uint64_t i = 0; i < header.numObstacles; ++i) {
+        const ObstacleFile::Entry& entry = file.getEntry(i);
+        const ObstacleFile::Type& type = file.getType(entry.typeIndex);
+        std::string id = file.getString(entry.idOffset, entry.idLength);
+
+        Obstacle obs(id, typeIds[entry.typeIndex], type.attenuationPerCut, type.attenuationPerMeter);
+        std::vector<Coord> sh;
+        sh.reserve(entry.numVertices);
+        const ObstacleFile::Vertex* vertices = file.getVertices(entry);
+        for (uint64_t j = 0; j < entry.numVertices; ++j) {
+            sh.push_back(Coord(vertices[j].x, vertices[j].y));
+        }
+        obs.setShape(std::move(sh), Coord(entry.minX, entry.minY), Coord(entry.maxX, entry.maxY));
+        if (!std::isinf(entry.base) || !std::isinf(entry.top)) {
+            if (!(entry.top >= entry.base)) {
+                throw cRuntimeError("Obstacle \"%s\" has negative height %f", id.c_str(), entry.top - entry.base);
+            }
+            obs.setHeight(entry.top - entry.base, entry.base);
+        }
+        add(std::move(obs));
+    }
+}
+
 void ObstacleControl::addFromTypeAndShape(std::string id, std::string typeId, std::vector<Coord> shape)
 {
     if (!isTypeSupported(typeId)) {
@@ -158,55 +291,160 @@ void ObstacleControl::addFromTypeAndShape(std::string id, std::string typeId, st
 
 void ObstacleControl::add(Obstacle obstacle)
 {
-    Obstacle* o = new Obstacle(obstacle);
+    Obstacle* o = new Obstacle(std::move(obstacle));
     obstacleOwner.emplace_back(o);
+    if (freeQueryIndices.empty()) {
+        o->queryIndex = numQueryIndices++;
+    }
+    else {
+        o->queryIndex = freeQueryIndices.back();
+        freeQueryIndices.pop_back();
+    }
 
     // visualize using AnnotationManager
     if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
 
-    cacheEntries.clear();
-    isBboxLookupDirty = true;
+    generation++;
+    invalidateCacheEntries(o);
+    invalidateRasters(o);
+    // the grid can be updated in place, the BVH is rebuilt on next use
+    if (!isBboxLookupDirty && obstacleIndex == ObstacleIndex::grid) {
+        bboxLookup.insert(o);
+    }
+    else {
+        isBboxLookupDirty = true;
+    }
 }
 
 void ObstacleControl::erase(const Obstacle* obstacle)
 {
     if (annotations && obstacle->visualRepresentation) annotations->erase(obstacle->visualRepresentation);
+
+    generation++;
+    invalidateCacheEntries(obstacle);
+    invalidateRasters(obstacle);
+
     for (auto itOwner = obstacleOwner.begin(); itOwner != obstacleOwner.end(); ++itOwner) {
         // find owning pointer and remove it to deallocate obstacle
         if (itOwner->get() == obstacle) {
+            if (!isBboxLookupDirty && obstacleIndex == ObstacleIndex::grid) {
+                bboxLookup.remove(itOwner->get());
+            }
+            else {
+                isBboxLookupDirty = true;
+            }
+            freeQueryIndices.push_back(obstacle->queryIndex);
             obstacleOwner.erase(itOwner);
             break;
         }
     }
+}
 
-    cacheEntries.clear();
-    isBboxLookupDirty = true;
+ObstacleControl::CacheKey ObstacleControl::makeCacheKey(const Coord& senderPos, const Coord& receiverPos) const
+{
+    if (cacheResolution == 0) return CacheKey(senderPos, receiverPos);
+    auto quantize = [this](const Coord& c) {
+        return Coord(std::round(c.x / cacheResolution) * cacheResolution, std::round(c.y / cacheResolution) * cacheResolution, std::round(c.z / cacheResolution) * cacheResolution);
+    };
+    return CacheKey(quantize(senderPos), quantize(receiverPos));
 }
 
-std::vector<std::pair<veins::Obstacle*, std::vector<double>>> ObstacleControl::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
+void ObstacleControl::invalidateCacheEntries(const Obstacle* obstacle)
 {
-    std::vector<std::pair<Obstacle*, std::vector<double>>> allIntersections;
+    // keys are rounded, so the transmissions they stand for may be up to half the resolution away
+    const Coord margin(cacheResolution / 2, cacheResolution / 2, cacheResolution / 2);
+    const Coord p1 = obstacle->getBboxP1() - margin;
+    const Coord p2 = obstacle->getBboxP2() + margin;
+    for (auto i = cacheEntries.begin(); i != cacheEntries.end();) {
+        const Coord& s = i->first.senderPos;
+        const Coord& r = i->first.receiverPos;
+        // keep entries whose segment's bounding box does not overlap with the obstacle's
+        bool overlaps = (std::max(s.x, r.x) >= p1.x) && (std::min(s.x, r.x) <= p2.x) && (std::max(s.y, r.y) >= p1.y) && (std::min(s.y, r.y) <= p2.y) && (std::max(s.z, r.z) >= p1.z) && (std::min(s.z, r.z) <= p2.z);
+        if (overlaps) {
+            cacheIndex.erase(i->first);
+            i = cacheEntries.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
 
+void ObstacleControl::invalidateRasters(const Obstacle* obstacle)
+{
+    // both ends of every transmission sampled by a raster lie within its area, so obstacles outside of it cannot affect the raster
+    const Coord& p1 = obstacle->getBboxP1();
+    const Coord& p2 = obstacle->getBboxP2();
+    for (auto& i : rasters) {
+        AttenuationRaster& raster = i.second;
+        if (raster.isDirty) continue;
+        const double extent = (raster.size - 1) * rasterResolution;
+        bool overlaps = (raster.origin.x + extent >= p1.x) && (raster.origin.x <= p2.x) && (raster.origin.y + extent >= p1.y) && (raster.origin.y <= p2.y);
+        if (overlaps) {
+            raster.isDirty = true;
+            areRastersDirty = true;
+        }
+    }
+}
+
+void ObstacleControl::updateLookup() const
+{
     // rebuild bounding box lookup structure if dirty (new obstacles added recently)
     if (isBboxLookupDirty) {
-        bboxLookup = rebuildBBoxLookup(obstacleOwner);
+        if (obstacleIndex == ObstacleIndex::bvh) {
+            bvhLookup = rebuildBVHLookup(obstacleOwner);
+        }
+        else {
+            bboxLookup = rebuildBBoxLookup(obstacleOwner, gridCellSize, bboxLayout);
+        }
         isBboxLookupDirty = false;
     }
+}
 
-    auto candidateObstacles = bboxLookup.findOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y});
+void ObstacleControl::forEachCandidate(const Coord& senderPos, const Coord& receiverPos, VisitStamps& visited, const std::function<void(Obstacle*)>& visit) const
+{
+    updateLookup();
 
-    // remove duplicates
-    sort(candidateObstacles.begin(), candidateObstacles.end());
-    candidateObstacles.erase(unique(candidateObstacles.begin(), candidateObstacles.end()), candidateObstacles.end());
+    // start a new query, making sure stamps of earlier queries cannot be mistaken for this one's
+    if (visited.stamps.size() < numQueryIndices) visited.stamps.resize(numQueryIndices, 0);
+    if (++visited.current == 0) {
+        std::fill(visited.stamps.begin(), visited.stamps.end(), 0);
+        visited.current = 1;
+    }
 
-    for (Obstacle* o : candidateObstacles) {
+    // skip obstacles entirely below or above the transmission
+    const BBoxLookup::ZRange zRange{std::min(senderPos.z, receiverPos.z), std::max(senderPos.z, receiverPos.z)};
+
+    // capture only one reference, so that std::function can store the lambda without allocating memory
+    struct {
+        VisitStamps& visited;
+        const std::function<void(Obstacle*)>& visit;
+    } query{visited, visit};
+    auto visitOnce = [&query](Obstacle* o) {
+        unsigned int& stamp = query.visited.stamps[o->queryIndex];
+        if (stamp == query.visited.current) return;
+        stamp = query.visited.current;
+        query.visit(o);
+    };
+    if (obstacleIndex == ObstacleIndex::bvh) {
+        bvhLookup.forEachOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y}, zRange, visitOnce);
+    }
+    else {
+        bboxLookup.forEachOverlapping({senderPos.x, senderPos.y}, {receiverPos.x, receiverPos.y}, zRange, visitOnce);
+    }
+}
+
+std::vector<std::pair<veins::Obstacle*, std::vector<double>>> ObstacleControl::getIntersections(const Coord& senderPos, const Coord& receiverPos) const
+{
+    std::vector<std::pair<Obstacle*, std::vector<double>>> allIntersections;
+    forEachCandidate(senderPos, receiverPos, visitStamps, [&](Obstacle* o) {
         // if obstacles has neither borders nor matter: bail.
-        if (o->getShape().size() < 2) continue;
+        if (o->getShape().size() < 2) return;
         auto foundIntersections = o->getIntersections(senderPos, receiverPos);
         if (!foundIntersections.empty() || o->containsPoint(senderPos) || o->containsPoint(receiverPos)) {
             allIntersections.emplace_back(o, foundIntersections);
         }
-    }
+    });
     return allIntersections;
 }
 
@@ -222,55 +460,177 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
     }
 
     // return cached result, if available
-    CacheKey cacheKey(senderPos, receiverPos);
-    CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(cacheKey);
-    if (cacheEntryIter != cacheEntries.end()) {
-        return cacheEntryIter->second;
+    CacheKey cacheKey = makeCacheKey(senderPos, receiverPos);
+    auto cacheIndexIter = cacheIndex.find(cacheKey);
+    if (cacheIndexIter != cacheIndex.end()) {
+        ++cacheHits;
+        // mark as most recently used
+        cacheEntries.splice(cacheEntries.begin(), cacheEntries, cacheIndexIter->second);
+        return cacheIndexIter->second->second;
     }
+    ++cacheMisses;
+
+    double factor = computeAttenuation(senderPos, receiverPos, visitStamps);
+
+    // cache result, evicting least recently used one if full
+    // (the nodes of the evicted result are recycled, so this does not allocate once the cache is full)
+    if (cacheSize == 0) return factor;
+    if (cacheEntries.size() >= cacheSize) {
+        cacheIndex.erase(cacheEntries.back().first);
+        cacheEntries.pop_back();
+        ++cacheEvictions;
+    }
+    cacheEntries.emplace_front(cacheKey, factor);
+    cacheIndex.emplace(cacheKey, cacheEntries.begin());
+
+    return factor;
+}
 
-    // get intersections
-    auto intersections = getIntersections(senderPos, receiverPos);
+double ObstacleControl::computeAttenuation(const Coord& senderPos, const Coord& receiverPos, VisitStamps& visited) const
+{
+    struct {
+        const Coord& senderPos;
+        const Coord& receiverPos;
+        double totalDistance;
+        double factor;
+    } attenuation{senderPos, receiverPos, senderPos.distance(receiverPos), 1};
+
+    forEachCandidate(senderPos, receiverPos, visited, [&attenuation](Obstacle* o) {
+        // bail if attenuation is already extremely high
+        if (attenuation.factor < 1e-30) return;
 
-    double factor = 1;
-    for (auto i = intersections.begin(); i != intersections.end(); ++i) {
-        auto o = i->first;
-        auto intersectAt = i->second;
+        // if obstacles has neither borders nor matter: bail.
+        if (o->getShape().size() < 2) return;
 
         // if beam interacts with neither borders nor matter: bail.
-        bool senderInside = o->containsPoint(senderPos);
-        bool receiverInside = o->containsPoint(receiverPos);
-        if ((intersectAt.size() == 0) && !senderInside && !receiverInside) continue;
-
-        // remember number of cuts before messing with intersection points
-        double numCuts = intersectAt.size();
-
-        // for distance calculation, make sure every other pair of points marks transition through matter and void, respectively.
-        if (senderInside) intersectAt.insert(intersectAt.begin(), 0);
-        if (receiverInside) intersectAt.push_back(1);
-        ASSERT((intersectAt.size() % 2) == 0);
-
-        // sum up distances in matter.
-        double fractionInObstacle = 0;
-        for (auto i = intersectAt.begin(); i != intersectAt.end();) {
-            double p1 = *(i++);
-            double p2 = *(i++);
-            fractionInObstacle += (p2 - p1);
-        }
+        size_t numCuts;
+        double fractionInObstacle;
+        if (!o->getCrossings(attenuation.senderPos, attenuation.receiverPos, numCuts, fractionInObstacle)) return;
 
         // calculate attenuation
-        double totalDistance = senderPos.distance(receiverPos);
-        double attenuation = (o->getAttenuationPerCut() * numCuts) + (o->getAttenuationPerMeter() * fractionInObstacle * totalDistance);
-        factor *= pow(10.0, -attenuation / 10.0);
+        double dB = (o->getAttenuationPerCut() * numCuts) + (o->getAttenuationPerMeter() * fractionInObstacle * attenuation.totalDistance);
+        attenuation.factor *= pow(10.0, -dB / 10.0);
+    });
+    return attenuation.factor;
+}
 
-        // bail if attenuation is already extremely high
-        if (factor < 1e-30) break;
+void ObstacleControl::registerStaticAntenna(int antennaId, std::string name, const Coord& antennaPos)
+{
+    Enter_Method_Silent();
+
+    AttenuationRaster& raster = rasters[antennaId];
+    raster.name = name;
+    raster.antennaPos = antennaPos;
+    raster.isDirty = true;
+    areRastersDirty = true;
+}
+
+bool ObstacleControl::lookupStaticAttenuation(int antennaId, const Coord& otherPos, double& factor) const
+{
+    Enter_Method_Silent();
+
+    if (rasterRadius == 0) return false;
+    auto rasterIter = rasters.find(antennaId);
+    if (rasterIter == rasters.end()) return false;
+    // let calculateAttenuation report missing obstacles
+    if (obstacleOwner.size() == 0) return false;
+
+    if (areRastersDirty) buildRasters();
+    const AttenuationRaster& raster = rasterIter->second;
+
+    // samples are only valid for positions at (roughly) the height they were taken at
+    if (std::abs(otherPos.z - rasterHeight) > rasterResolution / 2) {
+        ++rasterMisses;
+        return false;
+    }
+    const double fx = (otherPos.x - raster.origin.x) / rasterResolution;
+    const double fy = (otherPos.y - raster.origin.y) / rasterResolution;
+    if (!(fx >= 0 && fy >= 0 && fx < raster.size - 1 && fy < raster.size - 1)) {
+        ++rasterMisses;
+        return false;
+    }
+    ++rasterHits;
+
+    // interpolate attenuation (in dB) between the four surrounding samples
+    const size_t x = static_cast<size_t>(fx);
+    const size_t y = static_cast<size_t>(fy);
+    const double dx = fx - x;
+    const double dy = fy - y;
+    const float* row0 = &raster.attenuation[y * raster.size + x];
+    const float* row1 = row0 + raster.size;
+    const double attenuation = (1 - dy) * ((1 - dx) * row0[0] + dx * row0[1]) + dy * ((1 - dx) * row1[0] + dx * row1[1]);
+    factor = pow(10.0, -attenuation / 10.0);
+    return true;
+}
+
+void ObstacleControl::buildRasters() const
+{
+    updateLookup();
+
+    // lay out dirty rasters, collecting their rows as independent pieces of work
+    std::vector<std::pair<AttenuationRaster*, size_t>> rows;
+    for (auto& i : rasters) {
+        AttenuationRaster& raster = i.second;
+        if (!raster.isDirty) continue;
+        const size_t halfSize = static_cast<size_t>(std::ceil(rasterRadius / rasterResolution));
+        raster.size = 2 * halfSize + 1;
+        raster.origin = Coord(raster.antennaPos.x - halfSize * rasterResolution, raster.antennaPos.y - halfSize * rasterResolution, rasterHeight);
+        raster.attenuation.assign(raster.size * raster.size, 0);
+        for (size_t y = 0; y < raster.size; ++y) {
+            rows.emplace_back(&raster, y);
+        }
     }
 
-    // cache result
-    if (cacheEntries.size() >= 1000) cacheEntries.clear();
-    cacheEntries[cacheKey] = factor;
+    // computeAttenuation only reads obstacles and the (now up to date) lookup, so rows can be computed concurrently (each thread marking visited obstacles separately)
+    std::atomic<size_t> nextRow(0);
+    auto buildRows = [this, &rows, &nextRow]() {
+        VisitStamps visited;
+        for (size_t i = nextRow++; i < rows.size(); i = nextRow++) {
+            AttenuationRaster& raster = *rows[i].first;
+            const size_t y = rows[i].second;
+            for (size_t x = 0; x < raster.size; ++x) {
+                const Coord samplePos(raster.origin.x + x * rasterResolution, raster.origin.y + y * rasterResolution, rasterHeight);
+                raster.attenuation[y * raster.size + x] = -10 * std::log10(computeAttenuation(raster.antennaPos, samplePos, visited));
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < std::min<size_t>(rasterThreads, rows.size()); ++i) {
+        threads.emplace_back(buildRows);
+    }
+    buildRows();
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
-    return factor;
+    for (auto& i : rasters) {
+        AttenuationRaster& raster = i.second;
+        if (!raster.isDirty) continue;
+        raster.isDirty = false;
+        if (!rasterDirectory.empty()) saveRaster(raster);
+    }
+    areRastersDirty = false;
+}
+
+void ObstacleControl::saveRaster(const AttenuationRaster& raster) const
+{
+    std::string fileName = rasterDirectory + "/" + raster.name + ".asc";
+    std::ofstream file(fileName);
+    if (!file) {
+        throw cRuntimeError("Could not write attenuation raster to \"%s\"", fileName.c_str());
+    }
+    file << "ncols " << raster.size << "\n";
+    file << "nrows " << raster.size << "\n";
+    file << "xllcenter " << raster.origin.x << "\n";
+    file << "yllcenter " << raster.origin.y << "\n";
+    file << "cellsize " << rasterResolution << "\n";
+    // ASCII grids list the row with the largest y coordinate first
+    for (size_t y = raster.size; y-- > 0;) {
+        for (size_t x = 0; x < raster.size; ++x) {
+            file << (x ? " " : "") << raster.attenuation[y * raster.size + x];
+        }
+        file << "\n";
+    }
 }
 
 double ObstacleControl::getAttenuationPerCut(std::string type)
@@ -22,23 +22,30 @@
 
 #pragma once
 
+#include <functional>
+#include <list>
+#include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "veins/veins.h"
 
 #include "veins/base/utils/Coord.h"
+#include "veins/base/utils/RecyclingPool.h"
 #include "veins/modules/obstacle/Obstacle.h"
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/modules/utility/BBoxLookup.h"
+#include "veins/modules/utility/BVHLookup.h"
 
 namespace veins {
 
 /**
  * ObstacleControl models obstacles that block radio transmissions.
  *
- * Each Obstacle is a polygon.
+ * Each Obstacle is a polygon, optionally extruded to a given height.
  * Transmissions that cross one of the polygon's lines will have
  * their receive power set to zero.
+ * Transmissions passing above or below an extruded polygon are not attenuated by it.
  */
 class VEINS_API ObstacleControl : public cSimpleModule {
 public:
@@ -46,13 +53,17 @@ public:
     void initialize(int stage) override;
     int numInitStages() const override
     {
-        return 2;
+        return 3;
     }
     void finish() override;
     void handleMessage(cMessage* msg) override;
     void handleSelfMsg(cMessage* msg);
 
     void addFromXml(cXMLElement* xml);
+    /**
+     * add obstacle types and obstacles from a binary obstacle file (see ObstacleFile)
+     */
+    void addFromFile(std::string fileName);
     void addFromTypeAndShape(std::string id, std::string typeId, std::vector<Coord> shape);
     void add(Obstacle obstacle);
     void erase(const Obstacle* obstacle);
@@ -70,7 +81,29 @@ public:
      */
     double calculateAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
 
+    /**
+     * register an antenna that never moves, so that attenuation of transmissions to and from it can be looked up in a precomputed raster (if rasters are enabled)
+     */
+    void registerStaticAntenna(int antennaId, std::string name, const Coord& antennaPos);
+
+    /**
+     * look up additional attenuation by obstacles between a registered static antenna and otherPos in its raster, interpolating bilinearly.
+     * return false if there is no raster for this antenna or it does not cover otherPos (so calculateAttenuation needs to be used instead)
+     */
+    bool lookupStaticAttenuation(int antennaId, const Coord& otherPos, double& factor) const;
+
+    /**
+     * get a number which changes whenever obstacles are added or erased (so attenuations calculated before are no longer valid)
+     */
+    unsigned long getGeneration() const
+    {
+        return generation;
+    }
+
 protected:
+    /**
+     * sender and receiver position, rounded to cacheResolution
+     */
     struct CacheKey {
         const Coord senderPos;
         const Coord receiverPos;
@@ -81,32 +114,126 @@ protected:
         {
         }
 
-        bool operator<(const CacheKey& o) const
+        bool operator==(const CacheKey& o) const
         {
-            if (senderPos.x < o.senderPos.x) return true;
-            if (senderPos.x > o.senderPos.x) return false;
-            if (senderPos.y < o.senderPos.y) return true;
-            if (senderPos.y > o.senderPos.y) return false;
-            if (receiverPos.x < o.receiverPos.x) return true;
-            if (receiverPos.x > o.receiverPos.x) return false;
-            if (receiverPos.y < o.receiverPos.y) return true;
-            if (receiverPos.y > o.receiverPos.y) return false;
-            return false;
+            // compare exactly (unlike Coord::operator==), to be consistent with CacheKeyHash
+            return (senderPos.x == o.senderPos.x) && (senderPos.y == o.senderPos.y) && (senderPos.z == o.senderPos.z) && (receiverPos.x == o.receiverPos.x) && (receiverPos.y == o.receiverPos.y) && (receiverPos.z == o.receiverPos.z);
         }
     };
 
-    typedef std::map<CacheKey, double> CacheEntries;
+    struct CacheKeyHash {
+        size_t operator()(const CacheKey& k) const
+        {
+            std::hash<double> h;
+            size_t seed = 0;
+            for (double v : {k.senderPos.x, k.senderPos.y, k.senderPos.z, k.receiverPos.x, k.receiverPos.y, k.receiverPos.z}) {
+                seed ^= h(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
+    };
+
+    typedef std::pair<CacheKey, double> CacheEntry;
+    typedef std::list<CacheEntry, RecyclingAllocator<CacheEntry, ObstacleControl>> CacheEntries; /**< cached results, most recently used first (nodes of evicted results are recycled for new ones) */
+    typedef std::unordered_map<CacheKey, CacheEntries::iterator, CacheKeyHash, std::equal_to<CacheKey>, RecyclingAllocator<std::pair<const CacheKey, CacheEntries::iterator>, ObstacleControl>> CacheIndex;
+
+    /**
+     * return key of the cache entry for a transmission from senderPos to receiverPos
+     */
+    CacheKey makeCacheKey(const Coord& senderPos, const Coord& receiverPos) const;
+
+    /**
+     * remove cached results for all transmissions that might be affected by the given obstacle
+     */
+    void invalidateCacheEntries(const Obstacle* obstacle);
+
+    /**
+     * attenuation (in dB) by obstacles around a static antenna, sampled on a square grid of positions at height rasterHeight
+     */
+    struct AttenuationRaster {
+        std::string name; /**< name of the antenna, used as file name when saving */
+        Coord antennaPos;
+        Coord origin; /**< position of the first sample */
+        size_t size = 0; /**< number of samples per row and per column */
+        std::vector<float> attenuation; /**< samples, row by row (i.e., index is y * size + x) */
+        bool isDirty = true; /**< obstacles in range changed since building */
+    };
+
+    /**
+     * marks obstacles already visited by a query, so obstacles found more than once are considered only once (one instance per thread running queries)
+     */
+    struct VisitStamps {
+        std::vector<unsigned int> stamps; /**< stamp of the last query that visited the obstacle, by Obstacle::queryIndex */
+        unsigned int current = 0; /**< stamp of the running query */
+    };
+
+    /**
+     * rebuild the spatial index of obstacles, if obstacles were added or removed since it was last built
+     */
+    void updateLookup() const;
+
+    /**
+     * call visit once for every obstacle that might be hit by the transmission from senderPos to receiverPos, using visited to skip duplicates
+     */
+    void forEachCandidate(const Coord& senderPos, const Coord& receiverPos, VisitStamps& visited, const std::function<void(Obstacle*)>& visit) const;
+
+    /**
+     * calculate additional attenuation by obstacles without using (or filling) the cache
+     */
+    double computeAttenuation(const Coord& senderPos, const Coord& receiverPos, VisitStamps& visited) const;
+
+    /**
+     * (re)build all rasters that are dirty, using rasterThreads worker threads, then save them (if rasterDirectory is set)
+     */
+    void buildRasters() const;
+
+    /**
+     * write raster as an ESRI ASCII grid file to rasterDirectory
+     */
+    void saveRaster(const AttenuationRaster& raster) const;
+
+    /**
+     * mark rasters whose area overlaps with the given obstacle as dirty
+     */
+    void invalidateRasters(const Obstacle* obstacle);
+
+    enum class ObstacleIndex {
+        grid, ///< BBoxLookup
+        bvh ///< BVHLookup
+    };
 
     cXMLElement* obstaclesXml; /**< obstacles to add at startup */
+    ObstacleIndex obstacleIndex = ObstacleIndex::grid; /**< spatial index used to find candidate obstacles */
     int gridCellSize = 250; /**< size of square grid tiles for obstacle store */
+    BBoxLookup::Layout bboxLayout = BBoxLookup::Layout::structOfArrays; /**< memory layout of obstacle store */
+    size_t cacheSize = 1000; /**< maximum number of cached results */
+    double cacheResolution = 0; /**< positions are rounded to multiples of this before looking up cached results (0 to disable rounding) */
+    double rasterRadius = 0; /**< half the side length of the area covered by rasters around static antennas (0 to disable rasters) */
+    double rasterResolution = 2; /**< distance between samples of rasters */
+    double rasterHeight = 1.895; /**< height of samples of rasters */
+    unsigned int rasterThreads = 1; /**< number of threads building rasters */
+    std::string rasterDirectory; /**< directory to save rasters to (empty to not save them) */
 
     std::vector<std::unique_ptr<Obstacle>> obstacleOwner;
+    unsigned long generation = 0; /**< incremented whenever obstacles are added or erased */
+    size_t numQueryIndices = 0; /**< number of Obstacle::queryIndex values handed out so far */
+    std::vector<size_t> freeQueryIndices; /**< values of Obstacle::queryIndex no longer in use */
+    mutable VisitStamps visitStamps; /**< used by queries from the simulation's thread */
     AnnotationManager* annotations;
     AnnotationManager::Group* annotationGroup;
     std::map<std::string, double> perCut;
     std::map<std::string, double> perMeter;
     mutable CacheEntries cacheEntries;
+    mutable CacheIndex cacheIndex; /**< position of each key in cacheEntries */
+    mutable long cacheHits = 0;
+    mutable long cacheMisses = 0;
+    mutable long cacheEvictions = 0;
+    mutable std::map<int, AttenuationRaster> rasters; /**< rasters of registered static antennas, by antenna id */
+    mutable bool areRastersDirty = false; /**< at least one raster needs to be (re)built */
+    mutable long rasterHits = 0;
+    mutable long rasterMisses = 0;
     mutable BBoxLookup bboxLookup;
+    mutable BVHLookup bvhLookup;
     mutable bool isBboxLookupDirty = true;
 };
 
@@ -0,0 +1,143 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VEINS_OBSTACLEFILE_USE_MMAP
+#endif
+
+#include <cstring>
+
+#include "veins/modules/obstacle/ObstacleFile.h"
+
+using veins::ObstacleFile;
+
+namespace {
+
+/**
+ * return whether [offset, offset + length) lies within [0, total), without risking overflow
+ */
+bool isInRange(uint64_t offset, uint64_t length, uint64_t total)
+{
+    return (length <= total) && (offset <= total - length);
+}
+
+} // anonymous namespace
+
+constexpr char ObstacleFile::magic[8];
+constexpr uint32_t ObstacleFile::byteOrderMark;
+constexpr uint32_t ObstacleFile::version;
+
+ObstacleFile::ObstacleFile(std::string fileName)
+    : fileName(fileName)
+{
+#ifdef VEINS_OBSTACLEFILE_USE_MMAP
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) throw cRuntimeError("Could not open obstacle file \"%s\"", fileName.c_str());
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw cRuntimeError("Could not determine size of obstacle file \"%s\"", fileName.c_str());
+    }
+    size = st.st_size;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw cRuntimeError("Could not map obstacle file \"%s\" into memory", fileName.c_str());
+        }
+        data = static_cast<const char*>(mapped);
+    }
+    // the mapping stays valid after closing the file
+    close(fd);
+#else
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) throw cRuntimeError("Could not open obstacle file \"%s\"", fileName.c_str());
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    size = buffer.size();
+    data = buffer.data();
+#endif
+
+    try {
+        check();
+    }
+    catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+void ObstacleFile::check()
+{
+    // check that the header is valid and that all records fit into the file
+    header = reinterpret_cast<const Header*>(data);
+    if (size < sizeof(Header) || std::memcmp(header->magic, magic, sizeof(magic)) != 0) {
+        throw cRuntimeError("\"%s\" is not an obstacle file", fileName.c_str());
+    }
+    if (header->byteOrderMark != byteOrderMark) {
+        throw cRuntimeError("Obstacle file \"%s\" was written for a machine with different byte order", fileName.c_str());
+    }
+    if (header->version != version) {
+        throw cRuntimeError("Obstacle file \"%s\" has version %u, but expected version %u", fileName.c_str(), header->version, version);
+    }
+    // (counts are checked individually first, so that computing the expected size cannot overflow)
+    if (header->numTypes > size / sizeof(Type) || header->numObstacles > size / sizeof(Entry) || header->numVertices > size / sizeof(Vertex) || header->stringsSize > size) {
+        throw cRuntimeError("Obstacle file \"%s\" is shorter than its header says", fileName.c_str());
+    }
+    const uint64_t expectedSize = sizeof(Header) + header->numTypes * sizeof(Type) + header->numObstacles * sizeof(Entry) + header->numVertices * sizeof(Vertex) + header->stringsSize;
+    if (size != expectedSize) {
+        throw cRuntimeError("Obstacle file \"%s\" is %zu bytes long, but its header says it should be %llu bytes long", fileName.c_str(), size, (unsigned long long) expectedSize);
+    }
+    types = reinterpret_cast<const Type*>(data + sizeof(Header));
+    entries = reinterpret_cast<const Entry*>(types + header->numTypes);
+    vertices = reinterpret_cast<const Vertex*>(entries + header->numObstacles);
+    strings = reinterpret_cast<const char*>(vertices + header->numVertices);
+
+    // check references between records, so that users can follow them without checking again
+    for (uint64_t i = 0; i < header->numTypes; ++i) {
+        const Type& type = types[i];
+        if (!isInRange(type.idOffset, type.idLength, header->stringsSize)) throw cRuntimeError("Obstacle file \"%s\" is corrupt: id of type %llu out of range", fileName.c_str(), (unsigned long long) i);
+    }
+    for (uint64_t i = 0; i < header->numObstacles; ++i) {
+        const Entry& entry = entries[i];
+        if (!isInRange(entry.idOffset, entry.idLength, header->stringsSize)) throw cRuntimeError("Obstacle file \"%s\" is corrupt: id of obstacle %llu out of range", fileName.c_str(), (unsigned long long) i);
+        if (entry.typeIndex >= header->numTypes) throw cRuntimeError("Obstacle file \"%s\" is corrupt: type of obstacle %llu out of range", fileName.c_str(), (unsigned long long) i);
+        if (!isInRange(entry.firstVertex, entry.numVertices, header->numVertices)) throw cRuntimeError("Obstacle file \"%s\" is corrupt: shape of obstacle %llu out of range", fileName.c_str(), (unsigned long long) i);
+    }
+}
+
+ObstacleFile::~ObstacleFile()
+{
+    unmap();
+}
+
+void ObstacleFile::unmap()
+{
+#ifdef VEINS_OBSTACLEFILE_USE_MMAP
+    if (data) munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+}
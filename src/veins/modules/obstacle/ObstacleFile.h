@@ -0,0 +1,134 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * read-only view of a binary obstacle file, as written by bin/veins_convert_obstacles
+ *
+ * The file is mapped into memory (where supported) rather than parsed, so loading large sets of obstacles takes little more than copying them.
+ * It consists of a Header, followed by numTypes Type records, numObstacles Entry records, numVertices Vertex records, and stringsSize bytes of (not null-terminated) strings.
+ * All numbers are stored in the byte order of the machine reading the file, all records are multiples of 8 bytes long.
+ */
+class VEINS_API ObstacleFile {
+public:
+    static constexpr char magic[8] = {'V', 'E', 'I', 'N', 'S', 'O', 'B', 'S'};
+    static constexpr uint32_t byteOrderMark = 0x01020304;
+    static constexpr uint32_t version = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t byteOrderMark; /**< reads as a different number if the file was written on a machine with different byte order */
+        uint32_t version;
+        uint64_t numTypes;
+        uint64_t numObstacles;
+        uint64_t numVertices;
+        uint64_t stringsSize;
+    };
+    /**
+     * an obstacle type, as in <type id="building" db-per-cut="9" db-per-meter="0.4" />
+     */
+    struct Type {
+        uint64_t idOffset; /**< position of the id in the strings */
+        uint64_t idLength;
+        double attenuationPerCut;
+        double attenuationPerMeter;
+    };
+    /**
+     * an obstacle, as in <poly id="building#0" type="building" shape="..." height="20" base="0" />
+     */
+    struct Entry {
+        uint64_t idOffset; /**< position of the id in the strings */
+        uint64_t idLength;
+        uint64_t typeIndex; /**< index of the obstacle's Type */
+        uint64_t firstVertex; /**< index of the first Vertex of the obstacle's shape */
+        uint64_t numVertices;
+        double minX; /**< bounding box of the shape */
+        double minY;
+        double maxX;
+        double maxY;
+        double base; /**< vertical extent, -inf and +inf if the obstacle has no height */
+        double top;
+    };
+    struct Vertex {
+        double x;
+        double y;
+    };
+
+    /**
+     * open and check file, throwing cRuntimeError if it is not a valid obstacle file
+     */
+    explicit ObstacleFile(std::string fileName);
+    ~ObstacleFile();
+    ObstacleFile(const ObstacleFile&) = delete;
+    ObstacleFile& operator=(const ObstacleFile&) = delete;
+
+    const Header& getHeader() const
+    {
+        return *header;
+    }
+    const Type& getType(size_t i) const
+    {
+        return types[i];
+    }
+    const Entry& getEntry(size_t i) const
+    {
+        return entries[i];
+    }
+    const Vertex* getVertices(const Entry& entry) const
+    {
+        return vertices + entry.firstVertex;
+    }
+    std::string getString(uint64_t offset, uint64_t length) const
+    {
+        return std::string(strings + offset, length);
+    }
+
+protected:
+    /**
+     * check header and references between records, throwing cRuntimeError if any is invalid
+     */
+    void check();
+
+    /**
+     * release contents of the file
+     */
+    void unmap();
+
+    std::string fileName;
+    const char* data = nullptr; /**< contents of the file */
+    size_t size = 0; /**< length of the file */
+    std::vector<char> buffer; /**< holds contents of the file where it cannot be mapped into memory */
+    const Header* header = nullptr;
+    const Type* types = nullptr;
+    const Entry* entries = nullptr;
+    const Vertex* vertices = nullptr;
+    const char* strings = nullptr;
+};
+
+} // namespace veins
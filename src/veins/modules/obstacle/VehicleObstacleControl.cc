@@ -24,6 +24,7 @@
 #include <map>
 #include <set>
 
+#include <algorithm>
 #include <limits>
 #include <cmath>
 
@@ -31,13 +32,99 @@
 #include "veins/base/modules/BaseMobility.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/base/toolbox/Signal.h"
+#include "veins/base/toolbox/SignalExpression.h"
+#include "veins/base/utils/FindModule.h"
+#include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 
+using veins::Coord;
 using veins::MobileHostObstacle;
 using veins::Signal;
 using veins::VehicleObstacleControl;
 
 Define_Module(veins::VehicleObstacleControl);
 
+namespace {
+
+/**
+ * Return whether the line from p1 to p2 touches the box spanned by (x1, y1) and (x2, y2).
+ *
+ * Clips the line against the box (Liang-Barsky), so infinite box bounds are fine.
+ */
+bool lineTouchesBox(const Coord& p1, const Coord& p2, double x1, double y1, double x2, double y2)
+{
+    double t0 = 0;
+    double t1 = 1;
+    const double d[2] = {p2.x - p1.x, p2.y - p1.y};
+    const double lo[2] = {x1 - p1.x, y1 - p1.y};
+    const double hi[2] = {x2 - p1.x, y2 - p1.y};
+    for (size_t axis = 0; axis < 2; ++axis) {
+        if (d[axis] == 0) {
+            if (lo[axis] > 0 || hi[axis] < 0) return false;
+            continue;
+        }
+        double ta = lo[axis] / d[axis];
+        double tb = hi[axis] / d[axis];
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+
+/**
+ * Return whether point (x, y) is inside the quadrilateral given by its corners xs, ys.
+ */
+bool isPointInQuad(double x, double y, const double* xs, const double* ys)
+{
+    bool isInside = false;
+    for (size_t i = 0, j = 3; i < 4; j = i++) {
+        bool inYRangeUp = (y >= ys[i]) && (y < ys[j]);
+        bool inYRangeDown = (y >= ys[j]) && (y < ys[i]);
+        bool inYRange = inYRangeUp || inYRangeDown;
+        if (!inYRange) continue;
+        bool intersects = x < (xs[i] + ((y - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i])));
+        if (!intersects) continue;
+        isInside = !isInside;
+    }
+    return isInside;
+}
+
+/**
+ * Return the closest point (in [0, 1]) along (p1--p2) where it crosses the border of the quadrilateral given by its corners xs, ys.
+ *
+ * Return NaN if the line does not cross the border or starts inside the quadrilateral.
+ */
+double quadIntersectAt(double p1x, double p1y, double p2x, double p2y, const double* xs, const double* ys)
+{
+    const double not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+    if (isPointInQuad(p1x, p1y, xs, ys)) return not_a_number;
+
+    double closest = not_a_number;
+    const double p1VecX = p2x - p1x;
+    const double p1VecY = p2y - p1y;
+    for (size_t i = 0, j = 3; i < 4; j = i++) {
+        const double p2VecX = xs[j] - xs[i];
+        const double p2VecY = ys[j] - ys[i];
+        const double p1p2X = p1x - xs[i];
+        const double p1p2Y = p1y - ys[i];
+
+        const double D = (p1VecX * p2VecY - p1VecY * p2VecX);
+
+        const double p1Frac = (p2VecX * p1p2Y - p2VecY * p1p2X) / D;
+        if (p1Frac < 0 || p1Frac > 1) continue;
+
+        const double p2Frac = (p1VecX * p1p2Y - p1VecY * p1p2X) / D;
+        if (p2Frac < 0 || p2Frac > 1) continue;
+
+        if (!(closest <= p1Frac)) closest = p1Frac;
+    }
+    return closest;
+}
+
+} // namespace
+
 VehicleObstacleControl::~VehicleObstacleControl() = default;
 
 void VehicleObstacleControl::initialize(int stage)
@@ -47,6 +134,21 @@ void VehicleObstacleControl::initialize(int stage)
         if (annotations) {
             vehicleAnnotationGroup = annotations->createGroup("vehicleObstacles");
         }
+
+        gridCellSize = par("gridCellSize");
+        if (gridCellSize < 1) {
+            throw cRuntimeError("gridCellSize was %d, but must be a positive integer number", gridCellSize);
+        }
+        isVehicleSnapshotDirty = true;
+
+        // vehicles only change course when the TraCIScenarioManager advances the simulation, so a snapshot stays valid until the next timestep
+        TraCIScenarioManager* manager = TraCIScenarioManagerAccess().get();
+        if (manager) {
+            auto onTimestepEnd = [this](veins::SignalPayload<const SimTime&> payload) {
+                takeVehicleSnapshot();
+            };
+            signalManager.subscribeCallback(manager, TraCIScenarioManager::traciTimestepEndSignal, onTimestepEnd);
+        }
     }
 }
 
@@ -72,6 +174,7 @@ const MobileHostObstacle* VehicleObstacleControl::add(MobileHostObstacle obstacl
 {
     auto* o = new MobileHostObstacle(obstacle);
     vehicleObstacles.push_back(o);
+    isVehicleSnapshotDirty = true;
 
     return o;
 }
@@ -90,6 +193,7 @@ void VehicleObstacleControl::erase(const MobileHostObstacle* obstacle)
         }
     }
     ASSERT(erasedOne);
+    isVehicleSnapshotDirty = true;
     delete obstacle;
 }
 
@@ -270,7 +374,7 @@ Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pa
         c = -10 * log10((prodS * sumS) / (prodSsum * firstS * lastS));
     }
 
-    return attenuation_mo + attenuation_so + c;
+    return lazy(attenuation_mo) + attenuation_so + c;
 }
 
 std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObstacles(const AntennaPosition& senderPos_, const AntennaPosition& receiverPos_, const Signal& s) const
@@ -298,34 +402,38 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
         annotations->drawLine(senderPos, receiverPos, "blue", vehicleAnnotationGroup);
     }
 
-    double x1 = std::min(senderPos.x, receiverPos.x);
-    double x2 = std::max(senderPos.x, receiverPos.x);
-    double y1 = std::min(senderPos.y, receiverPos.y);
-    double y2 = std::max(senderPos.y, receiverPos.y);
+    findCandidates(senderPos, receiverPos, sStart);
 
-    for (auto o : vehicleObstacles) {
-        auto obstacleAntennaPositions = o->getInitialAntennaPositions();
-        double l = o->getLength();
-        double w = o->getWidth();
-        double h = o->getHeight();
+    const VehicleShapeSnapshot& snap = vehicleSnapshot;
+    const double dt = (sStart - snap.time).dbl();
+    const int senderId = senderPos_.getId();
+    const int receiverId = receiverPos_.getId();
+    double maxd = senderPos.distance(receiverPos);
+
+    for (auto i : candidateIndices) {
+        double h = snap.height[i];
 
-        auto hp_approx = o->getMobility()->getPositionAt(simTime());
+        EV << "checking vehicle in proximity of (" << (snap.minX[i] + snap.maxX[i]) / 2 << "," << (snap.minY[i] + snap.maxY[i]) / 2 << ") with height: " << h << endl;
 
-        EV << "checking vehicle in proximity of " << hp_approx.info() << " with height: " << h << " width: " << w << " length: " << l << endl;
+        // instead of moving the vehicle to where it is at sStart, move the line of sight by the opposite amount
+        double sx = senderPos.x - snap.velocityX[i] * dt;
+        double sy = senderPos.y - snap.velocityY[i] * dt;
+        double rx = receiverPos.x - snap.velocityX[i] * dt;
+        double ry = receiverPos.y - snap.velocityY[i] * dt;
 
-        if (!o->maybeInBounds(x1, y1, x2, y2, sStart)) {
+        if ((std::max(sx, rx) < snap.minX[i]) || (std::min(sx, rx) > snap.maxX[i]) || (std::max(sy, ry) < snap.minY[i]) || (std::min(sy, ry) > snap.maxY[i])) {
             EV_TRACE << "bounding boxes don't overlap: ignore" << std::endl;
             continue;
         }
 
         // check if this is either the sender or the receiver
         bool ignoreMe = false;
-        for (auto obstacleAntenna : obstacleAntennaPositions) {
-            if (obstacleAntenna.isSameAntenna(senderPos_)) {
+        for (size_t a = snap.antennaStart[i]; a < snap.antennaStart[i + 1]; ++a) {
+            if (snap.antennaIds[a] == senderId) {
                 EV_TRACE << "...this is the sender: ignore" << std::endl;
                 ignoreMe = true;
             }
-            if (obstacleAntenna.isSameAntenna(receiverPos_)) {
+            if (snap.antennaIds[a] == receiverId) {
                 EV_TRACE << "...this is the receiver: ignore" << std::endl;
                 ignoreMe = true;
             }
@@ -333,8 +441,7 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
         if (ignoreMe) continue;
 
         // this is a potential obstacle
-        double p1d = o->getIntersectionPoint(senderPos, receiverPos, sStart);
-        double maxd = senderPos.distance(receiverPos);
+        double p1d = quadIntersectAt(sx, sy, rx, ry, &snap.cornerX[4 * i], &snap.cornerY[4 * i]) * maxd;
         if (!std::isnan(p1d) && p1d > 0 && p1d < maxd) {
             auto it = potentialObstacles.begin();
             while (true) {
@@ -363,6 +470,120 @@ std::vector<std::pair<double, double>> VehicleObstacleControl::getPotentialObsta
     return potentialObstacles;
 }
 
+void VehicleObstacleControl::takeVehicleSnapshot() const
+{
+    VehicleShapeSnapshot& snap = vehicleSnapshot;
+    const size_t n = vehicleObstacles.size();
+
+    snap.time = simTime();
+    snap.cornerX.resize(4 * n);
+    snap.cornerY.resize(4 * n);
+    snap.minX.resize(n);
+    snap.minY.resize(n);
+    snap.maxX.resize(n);
+    snap.maxY.resize(n);
+    snap.velocityX.resize(n);
+    snap.velocityY.resize(n);
+    snap.height.resize(n);
+    snap.antennaStart.assign(1, 0);
+    snap.antennaIds.clear();
+    snap.maxExtent = 0;
+    snap.maxSpeed = 0;
+
+    size_t i = 0;
+    for (auto o : vehicleObstacles) {
+        auto shape = o->getShape(snap.time);
+        ASSERT(shape.size() == 4);
+        snap.minX[i] = snap.minY[i] = std::numeric_limits<double>::infinity();
+        snap.maxX[i] = snap.maxY[i] = -std::numeric_limits<double>::infinity();
+        for (size_t c = 0; c < 4; ++c) {
+            snap.cornerX[4 * i + c] = shape[c].x;
+            snap.cornerY[4 * i + c] = shape[c].y;
+            snap.minX[i] = std::min(snap.minX[i], shape[c].x);
+            snap.minY[i] = std::min(snap.minY[i], shape[c].y);
+            snap.maxX[i] = std::max(snap.maxX[i], shape[c].x);
+            snap.maxY[i] = std::max(snap.maxY[i], shape[c].y);
+        }
+        Coord v = o->getMobility()->getCurrentSpeed();
+        snap.velocityX[i] = v.x;
+        snap.velocityY[i] = v.y;
+        snap.height[i] = o->getHeight();
+        for (auto& antennaPosition : o->getInitialAntennaPositions()) {
+            snap.antennaIds.push_back(antennaPosition.getId());
+        }
+        snap.antennaStart.push_back(snap.antennaIds.size());
+
+        snap.maxExtent = std::max(snap.maxExtent, std::max(snap.maxX[i] - snap.minX[i], snap.maxY[i] - snap.minY[i]) / 2);
+        snap.maxSpeed = std::max(snap.maxSpeed, v.length());
+        ++i;
+    }
+
+    // sort vehicles into grid cells by the center of their bounding box
+    const Coord* playgroundSize = FindModule<BaseWorldUtility*>::findGlobalModule()->getPgs();
+    vehicleGridCols = std::floor(playgroundSize->x / gridCellSize) + 1;
+    vehicleGridRows = std::floor(playgroundSize->y / gridCellSize) + 1;
+    const size_t numCells = vehicleGridCols * vehicleGridRows;
+
+    // phase 1: determine cell of every vehicle and count vehicles per cell
+    std::vector<size_t> cellOf(n);
+    vehicleGridCellStart.assign(numCells + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const double x = (snap.minX[i] + snap.maxX[i]) / 2;
+        const double y = (snap.minY[i] + snap.maxY[i]) / 2;
+        const size_t col = std::min(size_t(std::max(0, int(x / gridCellSize))), vehicleGridCols - 1);
+        const size_t row = std::min(size_t(std::max(0, int(y / gridCellSize))), vehicleGridRows - 1);
+        cellOf[i] = col + row * vehicleGridCols;
+        ++vehicleGridCellStart[cellOf[i] + 1];
+    }
+
+    // phase 2: lay out cells in contiguous memory (counting sort keeps vehicles in their original order)
+    for (size_t cell = 0; cell < numCells; ++cell) {
+        vehicleGridCellStart[cell + 1] += vehicleGridCellStart[cell];
+    }
+    std::vector<size_t> fill(vehicleGridCellStart.begin(), vehicleGridCellStart.end() - 1);
+    vehicleGridCellIndices.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        vehicleGridCellIndices[fill[cellOf[i]]++] = i;
+    }
+
+    isVehicleSnapshotDirty = false;
+}
+
+void VehicleObstacleControl::findCandidates(const Coord& p1, const Coord& p2, simtime_t t) const
+{
+    if (isVehicleSnapshotDirty) takeVehicleSnapshot();
+
+    candidateIndices.clear();
+
+    // vehicles may have moved since the snapshot was taken, so search up to this distance around the line
+    const double reach = vehicleSnapshot.maxExtent + vehicleSnapshot.maxSpeed * std::abs((t - vehicleSnapshot.time).dbl());
+    const double inf = std::numeric_limits<double>::infinity();
+
+    const size_t firstCol = std::min(size_t(std::max(0, int((std::min(p1.x, p2.x) - reach) / gridCellSize))), vehicleGridCols - 1);
+    const size_t lastCol = std::min(size_t(std::max(0, int((std::max(p1.x, p2.x) + reach) / gridCellSize))), vehicleGridCols - 1);
+    const size_t firstRow = std::min(size_t(std::max(0, int((std::min(p1.y, p2.y) - reach) / gridCellSize))), vehicleGridRows - 1);
+    const size_t lastRow = std::min(size_t(std::max(0, int((std::max(p1.y, p2.y) + reach) / gridCellSize))), vehicleGridRows - 1);
+
+    for (size_t row = firstRow; row <= lastRow; ++row) {
+        for (size_t col = firstCol; col <= lastCol; ++col) {
+            const size_t cell = col + row * vehicleGridCols;
+            if (vehicleGridCellStart[cell] == vehicleGridCellStart[cell + 1]) continue;
+
+            // border cells also hold all vehicles beyond the playground edge
+            double x1 = (col == 0) ? -inf : col * gridCellSize - reach;
+            double x2 = (col == vehicleGridCols - 1) ? inf : (col + 1) * gridCellSize + reach;
+            double y1 = (row == 0) ? -inf : row * gridCellSize - reach;
+            double y2 = (row == vehicleGridRows - 1) ? inf : (row + 1) * gridCellSize + reach;
+            if (!lineTouchesBox(p1, p2, x1, y1, x2, y2)) continue;
+
+            candidateIndices.insert(candidateIndices.end(), vehicleGridCellIndices.begin() + vehicleGridCellStart[cell], vehicleGridCellIndices.begin() + vehicleGridCellStart[cell + 1]);
+        }
+    }
+
+    // check candidates in the same order as vehicleObstacles to keep results independent of the grid
+    std::sort(candidateIndices.begin(), candidateIndices.end());
+}
+
 void VehicleObstacleControl::drawVehicleObstacles(const simtime_t& t) const
 {
     for (auto o : vehicleObstacles) {
@@ -32,6 +32,7 @@
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/base/utils/Move.h"
 #include "veins/modules/obstacle/MobileHostObstacle.h"
+#include "veins/modules/utility/SignalManager.h"
 
 namespace veins {
 
@@ -43,6 +44,10 @@ class Signal;
  * Each Obstacle is a polygon.
  * Transmissions that cross one of the polygon's lines will have
  * their receive power set to zero.
+ *
+ * Whenever the TraCIScenarioManager finishes a timestep, the shapes of all vehicles
+ * are stored in flat arrays and sorted into a uniform grid, which all
+ * transmissions up to the next timestep are checked against.
  */
 class VEINS_API VehicleObstacleControl : public cSimpleModule {
 public:
@@ -95,6 +100,59 @@ protected:
     VehicleObstacles vehicleObstacles;
     AnnotationManager::Group* vehicleAnnotationGroup;
     void drawVehicleObstacles(const simtime_t& t) const;
+
+    /**
+     * Shapes of all vehicle obstacles at one point in time, stored as flat arrays.
+     *
+     * Vehicle i owns the entries at index i (and 4 * i to 4 * i + 3 for its corners).
+     * Until the next TraCI timestep, vehicles keep their heading and speed,
+     * so their shape at time t is the stored shape moved by velocity * (t - time).
+     */
+    struct VehicleShapeSnapshot {
+        simtime_t time; /**< time the shapes refer to */
+        std::vector<double> cornerX; /**< x coordinates of the four corners of each vehicle */
+        std::vector<double> cornerY; /**< y coordinates of the four corners of each vehicle */
+        std::vector<double> minX; /**< bounding box of each vehicle */
+        std::vector<double> minY;
+        std::vector<double> maxX;
+        std::vector<double> maxY;
+        std::vector<double> velocityX; /**< velocity of each vehicle */
+        std::vector<double> velocityY;
+        std::vector<double> height;
+        std::vector<size_t> antennaStart; /**< antennas of vehicle i are antennaIds[antennaStart[i]] to antennaIds[antennaStart[i + 1] - 1] */
+        std::vector<int> antennaIds;
+        double maxExtent = 0; /**< largest distance of any bounding box edge to the box center */
+        double maxSpeed = 0; /**< largest speed of any vehicle */
+
+        size_t size() const
+        {
+            return height.size();
+        }
+    };
+
+    /**
+     * store shapes of all vehicle obstacles at the current simulation time and sort them into the grid
+     */
+    void takeVehicleSnapshot() const;
+
+    /**
+     * fill candidateIndices with (ascending) indices into vehicleSnapshot of all vehicles that might overlap the line from p1 to p2 at time t
+     */
+    void findCandidates(const Coord& p1, const Coord& p2, simtime_t t) const;
+
+    int gridCellSize = 50; /**< size of square grid tiles for vehicle obstacle index */
+    SignalManager signalManager;
+
+    mutable bool isVehicleSnapshotDirty = true;
+    mutable VehicleShapeSnapshot vehicleSnapshot;
+
+    // uniform grid of vehicle obstacles, stored as one contiguous array of entries ordered by cell.
+    // Each vehicle is stored only once, in the cell of its bounding box center.
+    mutable size_t vehicleGridCols = 0;
+    mutable size_t vehicleGridRows = 0;
+    mutable std::vector<size_t> vehicleGridCellStart; /**< index of first entry of cell i in vehicleGridCellIndices; cell i ends at vehicleGridCellStart[i + 1] */
+    mutable std::vector<size_t> vehicleGridCellIndices; /**< indices into vehicleSnapshot, ordered by cell */
+    mutable std::vector<size_t> candidateIndices; /**< scratch buffer for candidates of the current query */
 };
 
 class VEINS_API VehicleObstacleControlAccess {
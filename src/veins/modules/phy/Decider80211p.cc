@@ -36,6 +36,7 @@
 #include "veins/modules/utility/ConstsPhy.h"
 
 #include "veins/base/toolbox/SignalUtils.h"
+#include "veins/base/phyLayer/InterferenceTracker.h"
 
 using namespace veins;
 
@@ -75,6 +76,9 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
             if (!currentSignal.first) {
                 // NIC is not yet synced to any frame, so lock and try to decode this frame
                 currentSignal.first = frame;
+                if (InterferenceTracker* tracker = phy->getInterferenceTracker()) {
+                    tracker->watch(frame, simTime(), signal.getReceptionStart() + PHY_HDR_PREAMBLE_DURATION, signal.getReceptionEnd());
+                }
                 EV_TRACE << "AirFrame: " << frame->getId() << " with (" << recvPower << " > " << minPowerLevel << ") -> Trying to receive AirFrame." << std::endl;
                 if (notifyRxStart) {
                     phy->sendControlMsgToMac(new cMessage("RxStartStatus", MacToPhyInterface::PHY_RX_START));
@@ -114,13 +118,20 @@ DeciderResult* Decider80211p::checkIfSignalOk(AirFrame* frame)
 
     start = start + PHY_HDR_PREAMBLE_DURATION; // its ok if something in the training phase is broken
 
-    AirFrameVector airFrames;
-    getChannelInfo(start, end, airFrames);
-
     double noise = phy->getNoiseFloorValue();
 
-    // Make sure to use the adjusted starting-point (which ignores the preamble)
-    double sinrMin = SignalUtils::getMinSINR(start, end, frame, airFrames, noise);
+    double sinrMin;
+    if (InterferenceTracker* tracker = phy->getInterferenceTracker()) {
+        // the tracker has been recording the interference since the frame was synced to
+        sinrMin = SignalUtils::getMinSINR(frame, tracker->getMaxInterference(frame), noise);
+    }
+    else {
+        channelFrames.clear();
+        getChannelInfo(start, end, channelFrames);
+
+        // Make sure to use the adjusted starting-point (which ignores the preamble)
+        sinrMin = SignalUtils::getMinSINR(start, end, frame, channelFrames, noise);
+    }
     double snrMin;
     if (collectCollisionStats) {
         // snrMin = SignalUtils::getMinSNR(start, end, frame, noise);
@@ -252,18 +263,24 @@ enum Decider80211p::PACKET_OK_RESULT Decider80211p::packetOk(double sinrMin, dou
 bool Decider80211p::cca(simtime_t_cref time, AirFrame* exclude)
 {
 
-    AirFrameVector airFrames;
-
-    // collect all AirFrames that intersect with [start, end]
-    getChannelInfo(time, time, airFrames);
-
     // In the reference implementation only centerFrequenvy - 5e6 (half bandwidth) is checked!
     // Although this is wrong, the same is done here to reproduce original results
     double minPower = phy->getNoiseFloorValue();
+
+    if (InterferenceTracker* tracker = phy->getInterferenceTracker()) {
+        ASSERT(time == simTime());
+        double power = tracker->isEmpty() ? 0 : tracker->getPowerAt(tracker->getSpectrum().indexOf(centerFrequency - 5e6), time, exclude);
+        return power < ccaThreshold - minPower;
+    }
+
+    // collect all AirFrames that intersect with [start, end]
+    channelFrames.clear();
+    getChannelInfo(time, time, channelFrames);
+
     bool isChannelIdle = minPower < ccaThreshold;
-    if (airFrames.size() > 0) {
-        size_t usedFreqIndex = airFrames.front()->getSignal().getSpectrum().indexOf(centerFrequency - 5e6);
-        isChannelIdle = SignalUtils::isChannelPowerBelowThreshold(time, airFrames, usedFreqIndex, ccaThreshold - minPower, exclude);
+    if (channelFrames.size() > 0) {
+        size_t usedFreqIndex = channelFrames.front()->getSignal().getSpectrum().indexOf(centerFrequency - 5e6);
+        isChannelIdle = SignalUtils::isChannelPowerBelowThreshold(time, channelFrames, usedFreqIndex, ccaThreshold - minPower, exclude);
     }
 
     return isChannelIdle;
@@ -122,6 +122,9 @@ protected:
     /** @brief notify PHY-RXSTART.indication  */
     bool notifyRxStart;
 
+    /** @brief AirFrames on the channel, reused (to keep its memory) for every query of the channel */
+    AirFrameVector channelFrames;
+
 protected:
     /**
      * @brief Checks a mapping against a specific threshold (element-wise).
@@ -27,6 +27,8 @@
 
 #include "veins/modules/phy/PhyLayer80211p.h"
 
+#include <typeinfo>
+
 #include "veins/modules/phy/Decider80211p.h"
 #include "veins/modules/analogueModel/SimplePathlossModel.h"
 #include "veins/modules/analogueModel/BreakpointPathlossModel.h"
@@ -64,6 +66,14 @@ void PhyLayer80211p::initialize(int stage)
         overallSpectrum = Spectrum(freqs);
     }
     BasePhyLayer::initialize(stage);
+    if (stage == 1) {
+        // BaseMobility itself never moves, so obstacle attenuation around the antenna can be precomputed
+        auto mobility = getMobilityModule();
+        if (obstacleControl && mobility && typeid(*mobility) == typeid(BaseMobility)) {
+            auto heading = Heading::fromCoord(mobility->getCurrentOrientation());
+            obstacleControl->registerStaticAntenna(getId(), getFullPath(), mobility->getPositionAt(simTime()) + antennaOffset.rotatedYaw(-heading.getRad()));
+        }
+    }
 }
 
 unique_ptr<AnalogueModel> PhyLayer80211p::getAnalogueModelFromName(std::string name, ParameterMap& params)
@@ -234,6 +244,7 @@ unique_ptr<AnalogueModel> PhyLayer80211p::initializeSimpleObstacleShadowing(Para
 
     ObstacleControl* obstacleControlP = ObstacleControlAccess().getIfExists();
     if (!obstacleControlP) throw cRuntimeError("initializeSimpleObstacleShadowing(): cannot find ObstacleControl module");
+    obstacleControl = obstacleControlP;
     return make_unique<SimpleObstacleShadowing>(this, *obstacleControlP, useTorus, playgroundSize);
 }
 
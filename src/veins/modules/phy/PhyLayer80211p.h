@@ -33,6 +33,8 @@
 
 namespace veins {
 
+class ObstacleControl;
+
 /**
  * @brief
  * Adaptation of the PhyLayer class for 802.11p.
@@ -79,6 +81,9 @@ protected:
      */
     bool allowTxDuringRx;
 
+    /** @brief ObstacleControl used by SimpleObstacleShadowing (if any), to register with if the antenna never moves */
+    ObstacleControl* obstacleControl = nullptr;
+
     enum ProtocolIds {
         IEEE_80211 = 12123
     };
@@ -21,6 +21,17 @@
 //
 
 #include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// AVX is not required at compile time, but used if the CPU supports it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define VEINS_BBOXLOOKUP_AVX
+#endif
 
 #include "veins/modules/utility/BBoxLookup.h"
 
@@ -28,6 +39,7 @@ namespace {
 
 using Point = veins::BBoxLookup::Point;
 using Box = veins::BBoxLookup::Box;
+using ZRange = veins::BBoxLookup::ZRange;
 
 /**
  * Helper structure representing a wireless ray from a sender to a receiver.
@@ -86,14 +98,167 @@ bool intersects(const Ray& ray, const Box& box)
     return (tmin < ray.length) && (tmax > 0);
 }
 
+/**
+ * Return whether two vertical extents overlap.
+ */
+bool overlaps(const ZRange& a, const ZRange& b)
+{
+    return (a.max >= b.min) && (a.min <= b.max);
+}
+
+/**
+ * Bounding boxes stored as one array per coordinate, see BBoxLookup::Layout::structOfArrays.
+ */
+struct BoxArrays {
+    const double* minX;
+    const double* minY;
+    const double* maxX;
+    const double* maxY;
+};
+
+/**
+ * Return whether ray intersects with the i-th box and the i-th box overlaps with bbox.
+ *
+ * Same as the fast rejection and intersects() in the array of structs path, but reading from separate coordinate arrays.
+ */
+bool overlapsAndIntersects(const Ray& ray, const Box& bbox, const BoxArrays& boxes, size_t i)
+{
+    if (boxes.maxX[i] < bbox.p1.x) return false;
+    if (boxes.minX[i] > bbox.p2.x) return false;
+    if (boxes.maxY[i] < bbox.p1.y) return false;
+    if (boxes.minY[i] > bbox.p2.y) return false;
+    const Box box{{boxes.minX[i], boxes.minY[i]}, {boxes.maxX[i], boxes.maxY[i]}};
+    return intersects(ray, box);
+}
+
+#if defined(VEINS_BBOXLOOKUP_AVX)
+/**
+ * Vectorized part of scanBoxes, testing 4 boxes per step using AVX instructions.
+ *
+ * Returns the index of the first box not tested yet. Must only be called if the CPU supports AVX.
+ */
+__attribute__((target("avx"))) size_t scanBoxesAvx(const Ray& ray, const Box& bbox, const BoxArrays& boxes, veins::Obstacle* const* lookup, const ZRange* zRanges, const ZRange& zRange, size_t from, size_t to, const std::function<void(veins::Obstacle*)>& visit)
+{
+    size_t i = from;
+    // pick near and far slab per axis once per ray, rather than per box
+    const double* nearX = ray.sign.x ? boxes.maxX : boxes.minX;
+    const double* farX = ray.sign.x ? boxes.minX : boxes.maxX;
+    const double* nearY = ray.sign.y ? boxes.maxY : boxes.minY;
+    const double* farY = ray.sign.y ? boxes.minY : boxes.maxY;
+    const __m256d originX = _mm256_set1_pd(ray.origin.x);
+    const __m256d originY = _mm256_set1_pd(ray.origin.y);
+    const __m256d invDirX = _mm256_set1_pd(ray.invDirection.x);
+    const __m256d invDirY = _mm256_set1_pd(ray.invDirection.y);
+    const __m256d length = _mm256_set1_pd(ray.length);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d bboxX1 = _mm256_set1_pd(bbox.p1.x);
+    const __m256d bboxY1 = _mm256_set1_pd(bbox.p1.y);
+    const __m256d bboxX2 = _mm256_set1_pd(bbox.p2.x);
+    const __m256d bboxY2 = _mm256_set1_pd(bbox.p2.y);
+    for (; i + 4 <= to; i += 4) {
+        // fast rejection
+        __m256d keep = _mm256_cmp_pd(_mm256_loadu_pd(boxes.maxX + i), bboxX1, _CMP_NLT_UQ);
+        keep = _mm256_and_pd(keep, _mm256_cmp_pd(_mm256_loadu_pd(boxes.minX + i), bboxX2, _CMP_NGT_UQ));
+        keep = _mm256_and_pd(keep, _mm256_cmp_pd(_mm256_loadu_pd(boxes.maxY + i), bboxY1, _CMP_NLT_UQ));
+        keep = _mm256_and_pd(keep, _mm256_cmp_pd(_mm256_loadu_pd(boxes.minY + i), bboxY2, _CMP_NGT_UQ));
+        // slab test
+        __m256d tmin = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(nearX + i), originX), invDirX);
+        __m256d tmax = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(farX + i), originX), invDirX);
+        const __m256d tymin = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(nearY + i), originY), invDirY);
+        const __m256d tymax = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(farY + i), originY), invDirY);
+        const __m256d miss = _mm256_or_pd(_mm256_cmp_pd(tmin, tymax, _CMP_GT_OQ), _mm256_cmp_pd(tymin, tmax, _CMP_GT_OQ));
+        tmin = _mm256_blendv_pd(tmin, tymin, _mm256_cmp_pd(tymin, tmin, _CMP_GT_OQ));
+        tmax = _mm256_blendv_pd(tmax, tymax, _mm256_cmp_pd(tymax, tmax, _CMP_LT_OQ));
+        keep = _mm256_andnot_pd(miss, keep);
+        keep = _mm256_and_pd(keep, _mm256_cmp_pd(tmin, length, _CMP_LT_OQ));
+        keep = _mm256_and_pd(keep, _mm256_cmp_pd(tmax, zero, _CMP_GT_OQ));
+        const int hits = _mm256_movemask_pd(keep);
+        for (size_t lane = 0; lane < 4; ++lane) {
+            if ((hits & (1 << lane)) && overlaps(zRanges[i + lane], zRange)) visit(lookup[i + lane]);
+        }
+    }
+    return i;
+}
+
+/**
+ * Return whether the CPU supports AVX instructions (checked once).
+ */
+bool cpuSupportsAvx()
+{
+    static const bool supported = __builtin_cpu_supports("avx");
+    return supported;
+}
+#endif
+
+/**
+ * Call visit with lookup[i] for every i in [from, to) where the i-th box passes overlapsAndIntersects() and zRanges[i] overlaps with zRange.
+ *
+ * Tests several boxes per step if SIMD instructions are available (SSE2 if enabled at compile time, AVX if the CPU supports it).
+ * Comparisons are chosen to give exactly the same results as the scalar code (including for NaN), and hits are visited in order.
+ */
+void scanBoxes(const Ray& ray, const Box& bbox, const BoxArrays& boxes, veins::Obstacle* const* lookup, const ZRange* zRanges, const ZRange& zRange, size_t from, size_t to, const std::function<void(veins::Obstacle*)>& visit)
+{
+    size_t i = from;
+#if defined(VEINS_BBOXLOOKUP_AVX)
+    if (cpuSupportsAvx()) i = scanBoxesAvx(ray, bbox, boxes, lookup, zRanges, zRange, from, to, visit);
+#endif
+#if defined(__SSE2__)
+    // pick near and far slab per axis once per ray, rather than per box
+    const double* nearX = ray.sign.x ? boxes.maxX : boxes.minX;
+    const double* farX = ray.sign.x ? boxes.minX : boxes.maxX;
+    const double* nearY = ray.sign.y ? boxes.maxY : boxes.minY;
+    const double* farY = ray.sign.y ? boxes.minY : boxes.maxY;
+    const __m128d originX = _mm_set1_pd(ray.origin.x);
+    const __m128d originY = _mm_set1_pd(ray.origin.y);
+    const __m128d invDirX = _mm_set1_pd(ray.invDirection.x);
+    const __m128d invDirY = _mm_set1_pd(ray.invDirection.y);
+    const __m128d length = _mm_set1_pd(ray.length);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d bboxX1 = _mm_set1_pd(bbox.p1.x);
+    const __m128d bboxY1 = _mm_set1_pd(bbox.p1.y);
+    const __m128d bboxX2 = _mm_set1_pd(bbox.p2.x);
+    const __m128d bboxY2 = _mm_set1_pd(bbox.p2.y);
+    for (; i + 2 <= to; i += 2) {
+        // fast rejection
+        __m128d keep = _mm_cmpnlt_pd(_mm_loadu_pd(boxes.maxX + i), bboxX1);
+        keep = _mm_and_pd(keep, _mm_cmpngt_pd(_mm_loadu_pd(boxes.minX + i), bboxX2));
+        keep = _mm_and_pd(keep, _mm_cmpnlt_pd(_mm_loadu_pd(boxes.maxY + i), bboxY1));
+        keep = _mm_and_pd(keep, _mm_cmpngt_pd(_mm_loadu_pd(boxes.minY + i), bboxY2));
+        // slab test
+        __m128d tmin = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(nearX + i), originX), invDirX);
+        __m128d tmax = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(farX + i), originX), invDirX);
+        const __m128d tymin = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(nearY + i), originY), invDirY);
+        const __m128d tymax = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(farY + i), originY), invDirY);
+        const __m128d miss = _mm_or_pd(_mm_cmpgt_pd(tmin, tymax), _mm_cmpgt_pd(tymin, tmax));
+        const __m128d useTymin = _mm_cmpgt_pd(tymin, tmin);
+        tmin = _mm_or_pd(_mm_and_pd(useTymin, tymin), _mm_andnot_pd(useTymin, tmin));
+        const __m128d useTymax = _mm_cmplt_pd(tymax, tmax);
+        tmax = _mm_or_pd(_mm_and_pd(useTymax, tymax), _mm_andnot_pd(useTymax, tmax));
+        keep = _mm_andnot_pd(miss, keep);
+        keep = _mm_and_pd(keep, _mm_cmplt_pd(tmin, length));
+        keep = _mm_and_pd(keep, _mm_cmpgt_pd(tmax, zero));
+        const int hits = _mm_movemask_pd(keep);
+        if ((hits & 1) && overlaps(zRanges[i], zRange)) visit(lookup[i]);
+        if ((hits & 2) && overlaps(zRanges[i + 1], zRange)) visit(lookup[i + 1]);
+    }
+#endif
+    // scalar fallback (and remainder of vectorized loop)
+    for (; i < to; ++i) {
+        if (overlapsAndIntersects(ray, bbox, boxes, i) && overlaps(zRanges[i], zRange)) visit(lookup[i]);
+    }
+}
+
 } // anonymous namespace
 
 namespace veins {
 
-BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize)
-    : bboxes()
+BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize, Layout layout, std::function<BBoxLookup::ZRange(Obstacle*)> makeZRange)
+    : layout(layout)
+    , bboxes()
     , obstacleLookup()
     , bboxCells()
+    , makeBBox(makeBBox)
+    , makeZRange(makeZRange)
     , cellSize(cellSize)
     , numCols(std::floor(scenarioX / cellSize) + 1)
     , numRows(std::floor(scenarioY / cellSize) + 1)
@@ -107,16 +272,16 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     const size_t numCells = numCols * numRows;
     std::vector<std::vector<BBoxLookup::Box>> protoCells(numCells);
     std::vector<std::vector<Obstacle*>> protoLookup(numCells);
+    std::vector<std::vector<BBoxLookup::ZRange>> protoZRanges(numCells);
+    const BBoxLookup::ZRange unbounded{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
     // fill protoCells with boundingBoxes
     size_t numEntries = 0;
     for (const auto obstaclePtr : obstacles) {
         auto bbox = makeBBox(obstaclePtr);
-        const size_t fromCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
-        const size_t toCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
-        const size_t fromRow = std::min(size_t(std::max(0, int(bbox.p1.y / cellSize))), numRows - 1);
-        const size_t toRow = std::min(size_t(std::max(0, int(bbox.p2.y / cellSize))), numRows - 1);
-        for (size_t row = fromRow; row <= toRow; ++row) {
-            for (size_t col = fromCol; col <= toCol; ++col) {
+        auto zRange = makeZRange ? makeZRange(obstaclePtr) : unbounded;
+        const auto cellRange = getCellRange(bbox);
+        for (size_t row = cellRange[2]; row <= cellRange[3]; ++row) {
+            for (size_t col = cellRange[0]; col <= cellRange[1]; ++col) {
                 ASSERT(row >= 0);
                 ASSERT(col >= 0);
                 ASSERT(row < numRows);
@@ -124,6 +289,7 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
                 const size_t cellIndex = col + row * numCols;
                 protoCells[cellIndex].push_back(bbox);
                 protoLookup[cellIndex].push_back(obstaclePtr);
+                protoZRanges[cellIndex].push_back(zRange);
                 ++numEntries;
                 ASSERT(protoCells[cellIndex].size() == protoLookup[cellIndex].size());
             }
@@ -131,8 +297,17 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
     }
 
     // phase 2: derive read-only data structure with fast lookup
-    bboxes.reserve(numEntries);
+    if (layout == Layout::structOfArrays) {
+        minX.reserve(numEntries);
+        minY.reserve(numEntries);
+        maxX.reserve(numEntries);
+        maxY.reserve(numEntries);
+    }
+    else {
+        bboxes.reserve(numEntries);
+    }
     obstacleLookup.reserve(numEntries);
+    zRanges.reserve(numEntries);
     bboxCells.reserve(numCells);
     size_t index = 0;
     for (size_t row = 0; row < numRows; ++row) {
@@ -144,23 +319,173 @@ BBoxLookup::BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BB
             const size_t count = currentCell.size();
             // copy over bboxes and obstacle lookups (in strict order)
             for (size_t entryIndex = 0; entryIndex < count; ++entryIndex) {
-                bboxes.push_back(currentCell.at(entryIndex));
+                const Box& bbox = currentCell.at(entryIndex);
+                if (layout == Layout::structOfArrays) {
+                    minX.push_back(bbox.p1.x);
+                    minY.push_back(bbox.p1.y);
+                    maxX.push_back(bbox.p2.x);
+                    maxY.push_back(bbox.p2.y);
+                }
+                else {
+                    bboxes.push_back(bbox);
+                }
                 obstacleLookup.push_back(currentLookup.at(entryIndex));
+                zRanges.push_back(protoZRanges.at(cellIndex).at(entryIndex));
             }
             // create lookup table for this cell
-            bboxCells.push_back({index, count});
+            bboxCells.push_back({index, count, count});
             // forward index to begin of next cell
             index += count;
-            ASSERT(bboxes.size() == index);
+            ASSERT(obstacleLookup.size() == index);
         }
     }
-    ASSERT(bboxes.size() == numEntries);
-    ASSERT(bboxes.size() == obstacleLookup.size());
+    ASSERT(obstacleLookup.size() == numEntries);
+    ASSERT(bboxes.size() == (layout == Layout::structOfArrays ? 0 : numEntries));
+    ASSERT(minX.size() == (layout == Layout::structOfArrays ? numEntries : 0));
+    numUsedEntries = numEntries;
 }
 
-std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver) const
+std::array<size_t, 4> BBoxLookup::getCellRange(const Box& bbox) const
+{
+    const size_t fromCol = std::min(size_t(std::max(0, int(bbox.p1.x / cellSize))), numCols - 1);
+    const size_t toCol = std::min(size_t(std::max(0, int(bbox.p2.x / cellSize))), numCols - 1);
+    const size_t fromRow = std::min(size_t(std::max(0, int(bbox.p1.y / cellSize))), numRows - 1);
+    const size_t toRow = std::min(size_t(std::max(0, int(bbox.p2.y / cellSize))), numRows - 1);
+    return {fromCol, toCol, fromRow, toRow};
+}
+
+void BBoxLookup::setEntry(size_t i, const Box& bbox, Obstacle* obstacle, const ZRange& zRange)
+{
+    if (layout == Layout::structOfArrays) {
+        minX[i] = bbox.p1.x;
+        minY[i] = bbox.p1.y;
+        maxX[i] = bbox.p2.x;
+        maxY[i] = bbox.p2.y;
+    }
+    else {
+        bboxes[i] = bbox;
+    }
+    obstacleLookup[i] = obstacle;
+    zRanges[i] = zRange;
+}
+
+void BBoxLookup::moveEntry(size_t i, size_t j)
+{
+    if (layout == Layout::structOfArrays) {
+        minX[j] = minX[i];
+        minY[j] = minY[i];
+        maxX[j] = maxX[i];
+        maxY[j] = maxY[i];
+    }
+    else {
+        bboxes[j] = bboxes[i];
+    }
+    obstacleLookup[j] = obstacleLookup[i];
+    zRanges[j] = zRanges[i];
+}
+
+void BBoxLookup::relocate(BBoxCell& cell, size_t newCapacity)
+{
+    ASSERT(newCapacity >= cell.count);
+    const size_t newIndex = obstacleLookup.size();
+    const size_t newSize = newIndex + newCapacity;
+    if (layout == Layout::structOfArrays) {
+        minX.resize(newSize);
+        minY.resize(newSize);
+        maxX.resize(newSize);
+        maxY.resize(newSize);
+    }
+    else {
+        bboxes.resize(newSize);
+    }
+    obstacleLookup.resize(newSize, nullptr);
+    zRanges.resize(newSize);
+    for (size_t i = 0; i < cell.count; ++i) {
+        moveEntry(cell.index + i, newIndex + i);
+    }
+    cell.index = newIndex;
+    cell.capacity = newCapacity;
+}
+
+void BBoxLookup::compact()
+{
+    // move cells to a fresh set of arrays (in cell order), leaving no space between them
+    BBoxLookup compacted;
+    compacted.layout = layout;
+    compacted.obstacleLookup.reserve(numUsedEntries);
+    for (auto& cell : bboxCells) {
+        const size_t index = compacted.obstacleLookup.size();
+        BBoxCell newCell{index, 0, 0};
+        compacted.relocate(newCell, cell.count);
+        for (size_t i = 0; i < cell.count; ++i) {
+            const size_t from = cell.index + i;
+            const Box bbox = (layout == Layout::structOfArrays) ? Box{{minX[from], minY[from]}, {maxX[from], maxY[from]}} : bboxes[from];
+            compacted.setEntry(index + i, bbox, obstacleLookup[from], zRanges[from]);
+        }
+        cell = {index, cell.count, cell.count};
+    }
+    bboxes = std::move(compacted.bboxes);
+    minX = std::move(compacted.minX);
+    minY = std::move(compacted.minY);
+    maxX = std::move(compacted.maxX);
+    maxY = std::move(compacted.maxY);
+    obstacleLookup = std::move(compacted.obstacleLookup);
+    zRanges = std::move(compacted.zRanges);
+    ASSERT(obstacleLookup.size() == numUsedEntries);
+}
+
+void BBoxLookup::insert(Obstacle* obstacle)
+{
+    ASSERT(makeBBox);
+    const Box bbox = makeBBox(obstacle);
+    const ZRange zRange = makeZRange ? makeZRange(obstacle) : ZRange{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+    const auto cellRange = getCellRange(bbox);
+    for (size_t row = cellRange[2]; row <= cellRange[3]; ++row) {
+        for (size_t col = cellRange[0]; col <= cellRange[1]; ++col) {
+            BBoxCell& cell = bboxCells[col + row * numCols];
+            // full cells move to the end of the arrays, with room to grow
+            if (cell.count == cell.capacity) relocate(cell, std::max(size_t(4), 2 * cell.capacity));
+            setEntry(cell.index + cell.count, bbox, obstacle, zRange);
+            ++cell.count;
+            ++numUsedEntries;
+        }
+    }
+    // relocated cells leave unused entries behind, so clean up once they outnumber the used ones
+    if (obstacleLookup.size() > 2 * numUsedEntries) compact();
+}
+
+void BBoxLookup::remove(Obstacle* obstacle)
+{
+    ASSERT(makeBBox);
+    const auto cellRange = getCellRange(makeBBox(obstacle));
+    for (size_t row = cellRange[2]; row <= cellRange[3]; ++row) {
+        for (size_t col = cellRange[0]; col <= cellRange[1]; ++col) {
+            BBoxCell& cell = bboxCells[col + row * numCols];
+            bool found = false;
+            for (size_t i = cell.index; i < cell.index + cell.count; ++i) {
+                if (obstacleLookup[i] != obstacle) continue;
+                // fill gap with last entry of cell
+                moveEntry(cell.index + cell.count - 1, i);
+                obstacleLookup[cell.index + cell.count - 1] = nullptr;
+                --cell.count;
+                --numUsedEntries;
+                found = true;
+                break;
+            }
+            ASSERT(found);
+        }
+    }
+}
+
+std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver, ZRange zRange) const
 {
     std::vector<Obstacle*> overlappingObstacles;
+    forEachOverlapping(sender, receiver, zRange, [&overlappingObstacles](Obstacle* obstacle) { overlappingObstacles.push_back(obstacle); });
+    return overlappingObstacles;
+}
+
+void BBoxLookup::forEachOverlapping(Point sender, Point receiver, ZRange zRange, const std::function<void(Obstacle*)>& visit) const
+{
     const Box bbox{
         {std::min(sender.x, receiver.x), std::min(sender.y, receiver.y)},
         {std::max(sender.x, receiver.x), std::max(sender.y, receiver.y)},
@@ -174,6 +499,7 @@ std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver)
     ASSERT(lastCol < numCols && lastRow < numRows);
     // precompute transmission ray properties
     const Ray ray = makeRay(sender, receiver);
+    const BoxArrays boxArrays{minX.data(), minY.data(), maxX.data(), maxY.data()};
     // iterate over cells
     for (size_t row = firstRow; row <= lastRow; ++row) {
         for (size_t col = firstCol; col <= lastCol; ++col) {
@@ -183,6 +509,10 @@ std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver)
             // derive cell for current cell coordinates
             const size_t cellIndex = col + row * numCols;
             const BBoxCell& cell = bboxCells.at(cellIndex);
+            if (layout == Layout::structOfArrays) {
+                scanBoxes(ray, bbox, boxArrays, obstacleLookup.data(), zRanges.data(), zRange, cell.index, cell.index + cell.count, visit);
+                continue;
+            }
             // iterate over bboxes in each cell
             for (size_t bboxIndex = cell.index; bboxIndex < cell.index + cell.count; ++bboxIndex) {
                 const Box& current = bboxes.at(bboxIndex);
@@ -191,13 +521,14 @@ std::vector<Obstacle*> BBoxLookup::findOverlapping(Point sender, Point receiver)
                 if (current.p1.x > bbox.p2.x) continue;
                 if (current.p2.y < bbox.p1.y) continue;
                 if (current.p1.y > bbox.p2.y) continue;
+                // skip obstacles below or above transmission
+                if (!overlaps(zRanges[bboxIndex], zRange)) continue;
                 // derive corresponding obstacle
                 if (!intersects(ray, current)) continue;
-                overlappingObstacles.push_back(obstacleLookup.at(bboxIndex));
+                visit(obstacleLookup.at(bboxIndex));
             }
         }
     }
-    return overlappingObstacles;
 }
 
 } // namespace veins
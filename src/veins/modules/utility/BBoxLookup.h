@@ -23,7 +23,9 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include "veins/veins.h"
@@ -37,11 +39,14 @@ class Obstacle;
  *
  * Stores bounding boxes for a set of obstacles and allows searching for them via another bounding box.
  *
- * Only considers a 2-dimensional plane (x and y coordinates).
+ * Only considers a 2-dimensional plane (x and y coordinates), plus an optional vertical extent (z coordinates) per obstacle:
+ * Queries may then skip obstacles that lie entirely below or above the transmission.
  *
  * In principle, any kind (or implementation) of a obstacle/shape/polygon is possible.
  * There only has to be a function to derive a bounding box for a given obstacle.
  * Obstacle instances are stored as pointers, so the lifetime of the obstacle instances is not managed by this class.
+ *
+ * Obstacles can be inserted and removed after construction, touching only the cells they cover.
  */
 class VEINS_API BBoxLookup {
 public:
@@ -56,26 +61,106 @@ public:
         Point p1;
         Point p2;
     };
+    /**
+     * Vertical extent of an obstacle or a transmission.
+     */
+    struct ZRange {
+        double min;
+        double max;
+    };
     struct BBoxCell {
         size_t index; /**< index of the first element of this cell in bboxes */
         size_t count; /**< number of elements in this cell; index + number = index of last element */
+        size_t capacity; /**< number of elements reserved for this cell, starting at index */
+    };
+    /**
+     * How bounding boxes are stored in memory (and, consequently, how they are tested).
+     */
+    enum class Layout {
+        arrayOfStructs, ///< one Box per entry, tested one after another
+        structOfArrays ///< one array per coordinate, tested several at a time using SIMD instructions (SSE2 if enabled at compile time, AVX if the CPU supports it)
     };
 
     BBoxLookup() = default;
-    BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize = 250);
+    /**
+     * Build the lookup. If makeZRange is not given, all obstacles are considered to extend infinitely in z direction.
+     */
+    BBoxLookup(const std::vector<Obstacle*>& obstacles, std::function<BBoxLookup::Box(Obstacle*)> makeBBox, double scenarioX, double scenarioY, int cellSize = 250, Layout layout = Layout::arrayOfStructs, std::function<BBoxLookup::ZRange(Obstacle*)> makeZRange = nullptr);
 
     /**
      * Return all obstacles which have their bounding box touched by the transmission from sender to receiver.
      *
      * The obstacles itself may not actually overlap with transmission (false positives are possible).
      */
-    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const;
+    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const
+    {
+        return findOverlapping(sender, receiver, {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+    }
+
+    /**
+     * Return all obstacles which have their bounding box touched by the transmission from sender to receiver and overlap with its vertical extent zRange.
+     *
+     * The obstacles itself may not actually overlap with transmission (false positives are possible).
+     */
+    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver, ZRange zRange) const;
+
+    /**
+     * Call visit for every obstacle which has its bounding box touched by the transmission from sender to receiver and overlaps with its vertical extent zRange.
+     *
+     * Same as findOverlapping (including duplicates and order), but without collecting results in a vector.
+     */
+    void forEachOverlapping(Point sender, Point receiver, ZRange zRange, const std::function<void(Obstacle*)>& visit) const;
+
+    /**
+     * Add an obstacle to all cells covered by its bounding box.
+     */
+    void insert(Obstacle* obstacle);
+
+    /**
+     * Remove an obstacle from all cells covered by its bounding box (which must not have changed since it was added).
+     */
+    void remove(Obstacle* obstacle);
 
 private:
+    /**
+     * Return the range of columns and rows (in this order) covered by bbox.
+     */
+    std::array<size_t, 4> getCellRange(const Box& bbox) const;
+
+    /**
+     * Store bbox, obstacle, and zRange at index i of the flat arrays.
+     */
+    void setEntry(size_t i, const Box& bbox, Obstacle* obstacle, const ZRange& zRange);
+
+    /**
+     * Copy entry from index i to index j of the flat arrays.
+     */
+    void moveEntry(size_t i, size_t j);
+
+    /**
+     * Move cell to the end of the flat arrays, reserving newCapacity entries there.
+     */
+    void relocate(BBoxCell& cell, size_t newCapacity);
+
+    /**
+     * Remove unused entries between cells from the flat arrays.
+     */
+    void compact();
+
     // NOTE: obstacles may occur multiple times in bboxes/obstacleLookup (if they are in multiple cells)
-    std::vector<Box> bboxes; /**< ALL bboxes in one chunck of contiguos memory, ordered by cells */
+    Layout layout = Layout::arrayOfStructs;
+    std::vector<Box> bboxes; /**< ALL bboxes in one chunck of contiguos memory, ordered by cells (only used for Layout::arrayOfStructs) */
+    // struct of arrays approach: same order as bboxes, but one array per coordinate (only used for Layout::structOfArrays)
+    std::vector<double> minX; /**< minX[i] is the smallest x coordinate of the i-th bbox */
+    std::vector<double> minY;
+    std::vector<double> maxX;
+    std::vector<double> maxY;
     std::vector<Obstacle*> obstacleLookup; /**< bboxes[i] belongs to instance in obstacleLookup[i] */
+    std::vector<ZRange> zRanges; /**< vertical extent of obstacleLookup[i] */
     std::vector<BBoxCell> bboxCells; /**< flattened matrix of X * Y BBoxCell instances */
+    size_t numUsedEntries = 0; /**< number of entries in the flat arrays that belong to a cell (the rest is unused space, left behind by insert or remove) */
+    std::function<BBoxLookup::Box(Obstacle*)> makeBBox;
+    std::function<BBoxLookup::ZRange(Obstacle*)> makeZRange;
     int cellSize = 0;
     size_t numCols = 0; /**< X BBoxCell instances in a row */
     size_t numRows = 0; /**< Y BBoxCell instances in a column */
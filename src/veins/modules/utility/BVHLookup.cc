@@ -0,0 +1,312 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "veins/modules/utility/BVHLookup.h"
+
+namespace {
+
+using Point = veins::BVHLookup::Point;
+using Box = veins::BVHLookup::Box;
+using ZRange = veins::BVHLookup::ZRange;
+
+constexpr size_t numBins = 16; /**< number of candidate split positions (+1) per node when evaluating the SAH */
+
+/**
+ * Helper structure representing a wireless ray from a sender to a receiver, along with its bounding box.
+ */
+struct Ray {
+    Point origin;
+    Point direction;
+    Point invDirection;
+    struct {
+        size_t x;
+        size_t y;
+    } sign;
+    double length;
+    Box bbox;
+};
+
+Ray makeRay(const Point& sender, const Point& receiver)
+{
+    const double dir_x = receiver.x - sender.x;
+    const double dir_y = receiver.y - sender.y;
+    Ray ray;
+    ray.origin = sender;
+    ray.length = std::sqrt(dir_x * dir_x + dir_y * dir_y);
+    ray.direction.x = dir_x / ray.length;
+    ray.direction.y = dir_y / ray.length;
+    ray.invDirection.x = 1.0 / ray.direction.x;
+    ray.invDirection.y = 1.0 / ray.direction.y;
+    ray.sign.x = ray.invDirection.x < 0;
+    ray.sign.y = ray.invDirection.y < 0;
+    ray.bbox = {{std::min(sender.x, receiver.x), std::min(sender.y, receiver.y)}, {std::max(sender.x, receiver.x), std::max(sender.y, receiver.y)}};
+    return ray;
+}
+
+/**
+ * Return whether box overlaps with the bounding box of the ray and the ray intersects with box; if so, store the distance along the ray at which it enters box in entry.
+ *
+ * Uses the same fast rejection and slab test (Williams et al., 2005) as BBoxLookup, so both find the same obstacles.
+ */
+bool intersects(const Ray& ray, const Box& box, double& entry)
+{
+    if (box.p2.x < ray.bbox.p1.x) return false;
+    if (box.p1.x > ray.bbox.p2.x) return false;
+    if (box.p2.y < ray.bbox.p1.y) return false;
+    if (box.p1.y > ray.bbox.p2.y) return false;
+
+    const double x[2]{box.p1.x, box.p2.x};
+    const double y[2]{box.p1.y, box.p2.y};
+    double tmin = (x[ray.sign.x] - ray.origin.x) * ray.invDirection.x;
+    double tmax = (x[1 - ray.sign.x] - ray.origin.x) * ray.invDirection.x;
+    double tymin = (y[ray.sign.y] - ray.origin.y) * ray.invDirection.y;
+    double tymax = (y[1 - ray.sign.y] - ray.origin.y) * ray.invDirection.y;
+
+    if ((tmin > tymax) || (tymin > tmax)) return false;
+    if (tymin > tmin) tmin = tymin;
+    if (tymax < tmax) tmax = tymax;
+    entry = tmin;
+    return (tmin < ray.length) && (tmax > 0);
+}
+
+/**
+ * Return whether two vertical extents overlap.
+ */
+bool overlaps(const ZRange& a, const ZRange& b)
+{
+    return (a.max >= b.min) && (a.min <= b.max);
+}
+
+Box emptyBox()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    return {{inf, inf}, {-inf, -inf}};
+}
+
+void grow(Box& box, const Box& other)
+{
+    box.p1.x = std::min(box.p1.x, other.p1.x);
+    box.p1.y = std::min(box.p1.y, other.p1.y);
+    box.p2.x = std::max(box.p2.x, other.p2.x);
+    box.p2.y = std::max(box.p2.y, other.p2.y);
+}
+
+/**
+ * Return the half perimeter of box, which is proportional to the probability of a random line hitting it (the 2D equivalent of surface area).
+ */
+double halfPerimeter(const Box& box)
+{
+    return (box.p2.x - box.p1.x) + (box.p2.y - box.p1.y);
+}
+
+double center(const Box& box, size_t axis)
+{
+    return (axis == 0) ? (box.p1.x + box.p2.x) / 2 : (box.p1.y + box.p2.y) / 2;
+}
+
+} // anonymous namespace
+
+namespace veins {
+
+BVHLookup::BVHLookup(const std::vector<Obstacle*>& obstacles, std::function<Box(Obstacle*)> makeBBox, std::function<ZRange(Obstacle*)> makeZRange, size_t maxLeafSize)
+    : nodes()
+    , bboxes()
+    , obstacleLookup()
+    , zRanges()
+    , maxLeafSize(maxLeafSize)
+{
+    ASSERT(maxLeafSize > 0);
+    if (obstacles.empty()) return;
+
+    std::vector<Box> boxes;
+    std::vector<ZRange> ranges;
+    boxes.reserve(obstacles.size());
+    ranges.reserve(obstacles.size());
+    for (const auto obstaclePtr : obstacles) {
+        boxes.push_back(makeBBox(obstaclePtr));
+        ranges.push_back(makeZRange ? makeZRange(obstaclePtr) : ZRange{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+    }
+
+    // build tree over a permutation of obstacles, then store boxes and obstacles in leaf order
+    std::vector<size_t> order(obstacles.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    nodes.reserve(2 * obstacles.size() / maxLeafSize + 1);
+    build(order, 0, order.size(), boxes, ranges, 0);
+
+    bboxes.reserve(order.size());
+    obstacleLookup.reserve(order.size());
+    zRanges.reserve(order.size());
+    for (auto i : order) {
+        bboxes.push_back(boxes[i]);
+        obstacleLookup.push_back(obstacles[i]);
+        zRanges.push_back(ranges[i]);
+    }
+    ASSERT(bboxes.size() == obstacles.size());
+    ASSERT(bboxes.size() == obstacleLookup.size());
+}
+
+void BVHLookup::build(std::vector<size_t>& order, size_t begin, size_t end, const std::vector<Box>& boxes, const std::vector<ZRange>& ranges, size_t depth)
+{
+    ASSERT(begin < end);
+    const size_t nodeIndex = nodes.size();
+    nodes.push_back({emptyBox(), {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()}, begin, end - begin, 0});
+
+    // determine bounds of node (and of centers of the boxes in it, to pick split positions from)
+    Box centers = emptyBox();
+    for (size_t i = begin; i < end; ++i) {
+        grow(nodes[nodeIndex].box, boxes[order[i]]);
+        nodes[nodeIndex].zRange.min = std::min(nodes[nodeIndex].zRange.min, ranges[order[i]].min);
+        nodes[nodeIndex].zRange.max = std::max(nodes[nodeIndex].zRange.max, ranges[order[i]].max);
+        const Box& b = boxes[order[i]];
+        grow(centers, {{center(b, 0), center(b, 1)}, {center(b, 0), center(b, 1)}});
+    }
+    if (end - begin <= maxLeafSize) return;
+
+    // split along the axis in which the centers are spread widest
+    const size_t axis = (centers.p2.x - centers.p1.x >= centers.p2.y - centers.p1.y) ? 0 : 1;
+    const double centerMin = (axis == 0) ? centers.p1.x : centers.p1.y;
+    const double centerExtent = (axis == 0) ? centers.p2.x - centers.p1.x : centers.p2.y - centers.p1.y;
+    if (centerExtent <= 0) return; // all centers coincide, no split can separate them
+
+    // evaluate the SAH for splits between numBins equally sized bins
+    auto binOf = [&](size_t boxIndex) {
+        return std::min(numBins - 1, size_t(numBins * (center(boxes[boxIndex], axis) - centerMin) / centerExtent));
+    };
+    size_t binCount[numBins] = {};
+    Box binBox[numBins];
+    std::fill(binBox, binBox + numBins, emptyBox());
+    for (size_t i = begin; i < end; ++i) {
+        const size_t bin = binOf(order[i]);
+        ++binCount[bin];
+        grow(binBox[bin], boxes[order[i]]);
+    }
+    double rightCost[numBins] = {};
+    Box accumulated = emptyBox();
+    size_t accumulatedCount = 0;
+    for (size_t bin = numBins - 1; bin > 0; --bin) {
+        grow(accumulated, binBox[bin]);
+        accumulatedCount += binCount[bin];
+        rightCost[bin] = (accumulatedCount > 0) ? halfPerimeter(accumulated) * accumulatedCount : 0;
+    }
+    double bestCost = halfPerimeter(nodes[nodeIndex].box) * (end - begin); // cost of not splitting at all
+    size_t bestSplit = 0;
+    accumulated = emptyBox();
+    accumulatedCount = 0;
+    for (size_t bin = 0; bin < numBins - 1; ++bin) {
+        grow(accumulated, binBox[bin]);
+        accumulatedCount += binCount[bin];
+        if (accumulatedCount == 0 || accumulatedCount == end - begin) continue;
+        const double cost = halfPerimeter(accumulated) * accumulatedCount + rightCost[bin + 1];
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestSplit = bin + 1;
+        }
+    }
+
+    size_t middle;
+    if (bestSplit > 0) {
+        middle = std::partition(order.begin() + begin, order.begin() + end, [&](size_t boxIndex) { return binOf(boxIndex) < bestSplit; }) - order.begin();
+    }
+    else {
+        // no split is cheaper than a leaf, but leaves must stay small: split at median
+        middle = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](size_t a, size_t b) { return center(boxes[a], axis) < center(boxes[b], axis); });
+    }
+    ASSERT(middle > begin && middle < end);
+
+    // turn into inner node, then append children
+    nodes[nodeIndex].count = 0;
+    maxDepth = std::max(maxDepth, depth + 1);
+    build(order, begin, middle, boxes, ranges, depth + 1);
+    nodes[nodeIndex].secondChild = nodes.size();
+    build(order, middle, end, boxes, ranges, depth + 1);
+}
+
+std::vector<Obstacle*> BVHLookup::findOverlapping(Point sender, Point receiver, ZRange zRange) const
+{
+    std::vector<Obstacle*> overlappingObstacles;
+    forEachOverlapping(sender, receiver, zRange, [&overlappingObstacles](Obstacle* obstacle) { overlappingObstacles.push_back(obstacle); });
+    return overlappingObstacles;
+}
+
+void BVHLookup::forEachOverlapping(Point sender, Point receiver, ZRange zRange, const std::function<void(Obstacle*)>& visit) const
+{
+    if (nodes.empty()) return;
+
+    // precompute transmission ray properties
+    const Ray ray = makeRay(sender, receiver);
+    double entry;
+    if (!overlaps(nodes[0].zRange, zRange) || !intersects(ray, nodes[0].box, entry)) return;
+
+    // every inner node on the current path leaves at most one child on the stack, plus the two children of the node being expanded
+    size_t inlineStack[maxInlineDepth + 2];
+    std::vector<size_t> deepStack;
+    size_t* stack = inlineStack;
+    if (maxDepth > maxInlineDepth) {
+        deepStack.resize(maxDepth + 2);
+        stack = deepStack.data();
+    }
+    size_t stackSize = 0;
+
+    // depth-first traversal, visiting the child the ray enters first before the other one
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+
+        if (node.count > 0) {
+            for (size_t bboxIndex = node.index; bboxIndex < node.index + node.count; ++bboxIndex) {
+                if (!overlaps(zRanges[bboxIndex], zRange)) continue;
+                if (!intersects(ray, bboxes[bboxIndex], entry)) continue;
+                visit(obstacleLookup[bboxIndex]);
+            }
+            continue;
+        }
+
+        const size_t firstChild = &node - nodes.data() + 1;
+        const size_t secondChild = node.secondChild;
+        double firstEntry;
+        double secondEntry;
+        const bool hitFirst = overlaps(nodes[firstChild].zRange, zRange) && intersects(ray, nodes[firstChild].box, firstEntry);
+        const bool hitSecond = overlaps(nodes[secondChild].zRange, zRange) && intersects(ray, nodes[secondChild].box, secondEntry);
+        if (hitFirst && hitSecond) {
+            // push farther child first, so closer child is popped next
+            if (firstEntry <= secondEntry) {
+                stack[stackSize++] = secondChild;
+                stack[stackSize++] = firstChild;
+            }
+            else {
+                stack[stackSize++] = firstChild;
+                stack[stackSize++] = secondChild;
+            }
+        }
+        else if (hitFirst) {
+            stack[stackSize++] = firstChild;
+        }
+        else if (hitSecond) {
+            stack[stackSize++] = secondChild;
+        }
+    }
+}
+
+} // namespace veins
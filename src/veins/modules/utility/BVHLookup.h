@@ -0,0 +1,111 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/modules/utility/BBoxLookup.h"
+
+namespace veins {
+
+class Obstacle;
+
+/**
+ * Bounding volume hierarchy to find obstacles (geometric shapes) along a transmission.
+ *
+ * Drop-in alternative to BBoxLookup (same bounding boxes, same findOverlapping contract) that adapts to the density of obstacles:
+ * Instead of cutting the scenario into cells of a fixed size, obstacles are recursively split into two groups,
+ * choosing the split that minimizes the surface area heuristic (SAH), or at the median if no split helps.
+ *
+ * Every obstacle is stored exactly once, so results never contain duplicates.
+ * Nodes are visited front-to-back, so obstacles closer to the sender tend to be returned first.
+ *
+ * Only considers a 2-dimensional plane (x and y coordinates), plus an optional vertical extent (z coordinates) per obstacle.
+ * Obstacle instances are stored as pointers, so the lifetime of the obstacle instances is not managed by this class.
+ */
+class VEINS_API BVHLookup {
+public:
+    using Point = BBoxLookup::Point;
+    using Box = BBoxLookup::Box;
+    using ZRange = BBoxLookup::ZRange;
+
+    BVHLookup() = default;
+    /**
+     * Build the hierarchy. If makeZRange is not given, all obstacles are considered to extend infinitely in z direction.
+     */
+    BVHLookup(const std::vector<Obstacle*>& obstacles, std::function<Box(Obstacle*)> makeBBox, std::function<ZRange(Obstacle*)> makeZRange = nullptr, size_t maxLeafSize = 4);
+
+    /**
+     * Return all obstacles which have their bounding box touched by the transmission from sender to receiver.
+     *
+     * The obstacles itself may not actually overlap with transmission (false positives are possible).
+     * Each obstacle is returned at most once.
+     */
+    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver) const
+    {
+        return findOverlapping(sender, receiver, {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+    }
+
+    /**
+     * Return all obstacles which have their bounding box touched by the transmission from sender to receiver and overlap with its vertical extent zRange.
+     *
+     * Subtrees entirely below or above the transmission are skipped.
+     */
+    std::vector<Obstacle*> findOverlapping(Point sender, Point receiver, ZRange zRange) const;
+
+    /**
+     * Call visit for every obstacle which has its bounding box touched by the transmission from sender to receiver and overlaps with its vertical extent zRange.
+     *
+     * Same as findOverlapping (including order), but without collecting results in a vector.
+     * Does not allocate memory unless the tree is deeper than maxInlineDepth.
+     */
+    void forEachOverlapping(Point sender, Point receiver, ZRange zRange, const std::function<void(Obstacle*)>& visit) const;
+
+private:
+    // nodes are stored in depth-first order: the first child of an inner node directly follows it
+    struct Node {
+        Box box; /**< bounding box of all obstacles below this node */
+        ZRange zRange; /**< vertical extent of all obstacles below this node */
+        size_t index; /**< leaf: index of the first element of this node in bboxes */
+        size_t count; /**< leaf: number of elements in this node; 0 for inner nodes */
+        size_t secondChild; /**< inner node: index of the second child in nodes */
+    };
+
+    /**
+     * Append a node for the entries [begin, end) of order (and, recursively, its children) to nodes.
+     */
+    void build(std::vector<size_t>& order, size_t begin, size_t end, const std::vector<Box>& boxes, const std::vector<ZRange>& ranges, size_t depth);
+
+    static constexpr size_t maxInlineDepth = 62; /**< traversal of trees up to this deep uses a stack of fixed size */
+
+    std::vector<Node> nodes; /**< flattened tree, nodes[0] is the root */
+    std::vector<Box> bboxes; /**< ALL bboxes in one chunk of contiguous memory, ordered by leaves */
+    std::vector<Obstacle*> obstacleLookup; /**< bboxes[i] belongs to instance in obstacleLookup[i] */
+    std::vector<ZRange> zRanges; /**< vertical extent of obstacleLookup[i] */
+    size_t maxLeafSize = 4;
+    size_t maxDepth = 0; /**< number of inner nodes on the longest path from the root to a leaf */
+};
+
+} // namespace veins
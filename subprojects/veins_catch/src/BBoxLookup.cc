@@ -0,0 +1,288 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "veins/modules/utility/BBoxLookup.h"
+#include "veins/modules/utility/BVHLookup.h"
+#include "veins/modules/obstacle/Obstacle.h"
+
+using veins::BBoxLookup;
+using veins::BVHLookup;
+using veins::Coord;
+using veins::Obstacle;
+
+namespace {
+
+/**
+ * Load all buildings from a SUMO poly file, moved such that the smallest coordinate is (0, 0).
+ *
+ * Only reads the shape attribute of poly elements, which is all that is needed to fill a BBoxLookup.
+ */
+std::vector<std::unique_ptr<Obstacle>> loadBuildings(const std::string& fileName, Coord& size)
+{
+    std::vector<std::unique_ptr<Obstacle>> obstacles;
+    std::vector<Obstacle::Coords> shapes;
+
+    std::ifstream file(fileName);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find("<poly ") == std::string::npos) continue;
+        if (line.find("type=\"building\"") == std::string::npos) continue;
+        const auto shapeBegin = line.find("shape=\"");
+        if (shapeBegin == std::string::npos) continue;
+        const auto shapeEnd = line.find('"', shapeBegin + 7);
+        std::istringstream shapeStream(line.substr(shapeBegin + 7, shapeEnd - shapeBegin - 7));
+        Obstacle::Coords shape;
+        std::string point;
+        while (shapeStream >> point) {
+            const auto comma = point.find(',');
+            shape.push_back(Coord(std::stod(point.substr(0, comma)), std::stod(point.substr(comma + 1))));
+        }
+        shapes.push_back(shape);
+    }
+
+    Coord min(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+    Coord max(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity());
+    for (auto& shape : shapes) {
+        for (auto& c : shape) {
+            min.x = std::min(min.x, c.x);
+            min.y = std::min(min.y, c.y);
+            max.x = std::max(max.x, c.x);
+            max.y = std::max(max.y, c.y);
+        }
+    }
+    size = Coord(max.x - min.x, max.y - min.y);
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (auto& c : shapes[i]) {
+            c.x -= min.x;
+            c.y -= min.y;
+        }
+        obstacles.emplace_back(new Obstacle(std::to_string(i), "building", 9, 0.4));
+        obstacles.back()->setShape(shapes[i]);
+    }
+    return obstacles;
+}
+
+/**
+ * Load the buildings of the Erlangen example, which is looked for relative to the veins_catch directory and relative to its src directory.
+ */
+std::vector<std::unique_ptr<Obstacle>> loadErlangen(Coord& size)
+{
+    for (auto fileName : {"../../examples/veins/erlangen.poly.xml", "../../../examples/veins/erlangen.poly.xml"}) {
+        auto obstacles = loadBuildings(fileName, size);
+        if (!obstacles.empty()) return obstacles;
+    }
+    return {};
+}
+
+std::vector<Obstacle*> getPointers(const std::vector<std::unique_ptr<Obstacle>>& obstacles)
+{
+    std::vector<Obstacle*> obstaclePointers;
+    for (auto& o : obstacles) {
+        obstaclePointers.push_back(o.get());
+    }
+    return obstaclePointers;
+}
+
+BBoxLookup::Box getBBox(Obstacle* o)
+{
+    return BBoxLookup::Box{{o->getBboxP1().x, o->getBboxP1().y}, {o->getBboxP2().x, o->getBboxP2().y}};
+}
+
+BBoxLookup makeLookup(const std::vector<std::unique_ptr<Obstacle>>& obstacles, const Coord& size, BBoxLookup::Layout layout)
+{
+    return BBoxLookup(getPointers(obstacles), getBBox, size.x, size.y, 250, layout);
+}
+
+/**
+ * Return pairs of sender and receiver positions at most 500m apart, spread across the scenario.
+ */
+std::vector<std::pair<BBoxLookup::Point, BBoxLookup::Point>> makeTransmissions(const Coord& size, size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> xDist(0, size.x);
+    std::uniform_real_distribution<double> yDist(0, size.y);
+    std::uniform_real_distribution<double> offsetDist(-250, 250);
+    std::vector<std::pair<BBoxLookup::Point, BBoxLookup::Point>> transmissions;
+    for (size_t i = 0; i < count; ++i) {
+        BBoxLookup::Point sender{xDist(rng), yDist(rng)};
+        BBoxLookup::Point receiver{sender.x + offsetDist(rng), sender.y + offsetDist(rng)};
+        // include axis-aligned transmissions, for which the ray has infinite inverse direction
+        if (i % 10 == 0) receiver.x = sender.x;
+        if (i % 10 == 1) receiver.y = sender.y;
+        transmissions.push_back({sender, receiver});
+    }
+    return transmissions;
+}
+
+} // namespace
+
+SCENARIO("BBoxLookup finds the same obstacles in either memory layout", "[bboxLookup]")
+{
+    GIVEN("The buildings of the Erlangen example")
+    {
+        Coord size;
+        auto obstacles = loadErlangen(size);
+        REQUIRE(obstacles.size() > 0);
+
+        auto aos = makeLookup(obstacles, size, BBoxLookup::Layout::arrayOfStructs);
+        auto soa = makeLookup(obstacles, size, BBoxLookup::Layout::structOfArrays);
+
+        THEN("both layouts return identical results in identical order")
+        {
+            size_t numFound = 0;
+            for (auto& t : makeTransmissions(size, 2000)) {
+                auto expected = aos.findOverlapping(t.first, t.second);
+                auto actual = soa.findOverlapping(t.first, t.second);
+                REQUIRE(actual == expected);
+                numFound += expected.size();
+            }
+            REQUIRE(numFound > 0);
+        }
+    }
+}
+
+SCENARIO("BBoxLookup can be updated incrementally", "[bboxLookup]")
+{
+    GIVEN("The buildings of the Erlangen example")
+    {
+        Coord size;
+        auto obstacles = loadErlangen(size);
+        REQUIRE(obstacles.size() > 0);
+        auto obstaclePointers = getPointers(obstacles);
+
+        WHEN("building a lookup from half of them, then inserting the rest and removing every third")
+        {
+            THEN("it finds the same obstacles as one built from the remaining obstacles, in either memory layout")
+            {
+                for (auto layout : {BBoxLookup::Layout::arrayOfStructs, BBoxLookup::Layout::structOfArrays}) {
+                    std::vector<Obstacle*> firstHalf(obstaclePointers.begin(), obstaclePointers.begin() + obstaclePointers.size() / 2);
+                    BBoxLookup updated(firstHalf, getBBox, size.x, size.y, 250, layout);
+                    std::vector<Obstacle*> remaining;
+                    for (size_t i = 0; i < obstaclePointers.size(); ++i) {
+                        if (i >= firstHalf.size()) updated.insert(obstaclePointers[i]);
+                        if (i % 3 == 0) {
+                            updated.remove(obstaclePointers[i]);
+                        }
+                        else {
+                            remaining.push_back(obstaclePointers[i]);
+                        }
+                    }
+                    BBoxLookup rebuilt(remaining, getBBox, size.x, size.y, 250, layout);
+
+                    for (auto& t : makeTransmissions(size, 500)) {
+                        auto expected = rebuilt.findOverlapping(t.first, t.second);
+                        auto actual = updated.findOverlapping(t.first, t.second);
+                        std::sort(expected.begin(), expected.end());
+                        std::sort(actual.begin(), actual.end());
+                        REQUIRE(actual == expected);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("BVHLookup finds the same obstacles as BBoxLookup", "[bboxLookup]")
+{
+    GIVEN("The buildings of the Erlangen example")
+    {
+        Coord size;
+        auto obstacles = loadErlangen(size);
+        REQUIRE(obstacles.size() > 0);
+
+        auto grid = makeLookup(obstacles, size, BBoxLookup::Layout::arrayOfStructs);
+        BVHLookup bvh(getPointers(obstacles), getBBox);
+
+        THEN("both return the same set of obstacles, the BVH without duplicates")
+        {
+            for (auto& t : makeTransmissions(size, 2000)) {
+                auto expected = grid.findOverlapping(t.first, t.second);
+                std::sort(expected.begin(), expected.end());
+                expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+                auto actual = bvh.findOverlapping(t.first, t.second);
+                const size_t numFound = actual.size();
+                std::sort(actual.begin(), actual.end());
+                actual.erase(std::unique(actual.begin(), actual.end()), actual.end());
+                REQUIRE(actual.size() == numFound);
+                REQUIRE(actual == expected);
+            }
+        }
+    }
+
+    GIVEN("No obstacles at all")
+    {
+        BVHLookup bvh({}, getBBox);
+
+        THEN("nothing is found")
+        {
+            REQUIRE(bvh.findOverlapping({0, 0}, {100, 100}).empty());
+        }
+    }
+}
+
+TEST_CASE("BBoxLookup performance on the Erlangen example", "[.][bboxLookup][benchmark]")
+{
+    Coord size;
+    auto obstacles = loadErlangen(size);
+    REQUIRE(obstacles.size() > 0);
+
+    auto aos = makeLookup(obstacles, size, BBoxLookup::Layout::arrayOfStructs);
+    auto soa = makeLookup(obstacles, size, BBoxLookup::Layout::structOfArrays);
+    BVHLookup bvh(getPointers(obstacles), getBBox);
+    auto transmissions = makeTransmissions(size, 1000);
+
+    BENCHMARK("array of structs")
+    {
+        size_t numFound = 0;
+        for (auto& t : transmissions) {
+            numFound += aos.findOverlapping(t.first, t.second).size();
+        }
+        return numFound;
+    };
+
+    BENCHMARK("struct of arrays")
+    {
+        size_t numFound = 0;
+        for (auto& t : transmissions) {
+            numFound += soa.findOverlapping(t.first, t.second).size();
+        }
+        return numFound;
+    };
+
+    BENCHMARK("bounding volume hierarchy")
+    {
+        size_t numFound = 0;
+        for (auto& t : transmissions) {
+            numFound += bvh.findOverlapping(t.first, t.second).size();
+        }
+        return numFound;
+    };
+}
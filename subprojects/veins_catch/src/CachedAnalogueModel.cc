@@ -0,0 +1,164 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/phyLayer/CachedAnalogueModel.h"
+#include "veins/modules/analogueModel/SimplePathlossModel.h"
+#include "veins/base/toolbox/Spectrum.h"
+#include "veins/base/toolbox/Signal.h"
+#include "testutils/Simulation.h"
+#include "testutils/Component.h"
+
+using namespace veins;
+
+namespace {
+
+/**
+ * Stands in for obstacle shadowing: attenuates by a fixed factor, counts how often it was applied, and lets the test change its obstacles.
+ */
+class CountingShadowingModel : public AnalogueModel {
+public:
+    CountingShadowingModel(cComponent* owner, double factor, unsigned long& generation, int& numApplied)
+        : AnalogueModel(owner)
+        , factor(factor)
+        , generation(generation)
+        , numApplied(numApplied)
+    {
+    }
+
+    void filterSignal(Signal* signal) override
+    {
+        numApplied++;
+        *signal *= factor;
+    }
+
+    bool neverIncreasesPower() override
+    {
+        return true;
+    }
+
+    bool dependsOnlyOnLinkGeometry() override
+    {
+        return true;
+    }
+
+    unsigned long getLinkGeometryGeneration() override
+    {
+        return generation;
+    }
+
+protected:
+    const double factor;
+    unsigned long& generation;
+    int& numApplied;
+};
+
+Signal makeFrame(const Spectrum& spectrum, simtime_t start, Coord senderPosition, Coord receiverPosition)
+{
+    Signal signal(spectrum, start, 1);
+    signal = 1;
+    signal.setSenderPoa({AntennaPosition(1, senderPosition, Coord(0, 0, 0), simTime()), {}, nullptr});
+    signal.setReceiverPoa({AntennaPosition(2, receiverPosition, Coord(0, 0, 0), simTime()), {}, nullptr});
+    return signal;
+}
+
+} // namespace
+
+SCENARIO("CachedAnalogueModel", "[phyLayer]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent dc(&ds);
+    double centerFreq = 5.9e9;
+    Spectrum spectrum(Spectrum::Frequencies{centerFreq - 5e6, centerFreq, centerFreq + 5e6});
+
+    unsigned long obstacleGeneration = 0;
+    int numShadowingApplied = 0;
+    CachedAnalogueModel pathloss(&dc, make_unique<SimplePathlossModel>(&dc, 2.0, false, Coord(0, 0, 0)));
+    CachedAnalogueModel shadowing(&dc, make_unique<CountingShadowingModel>(&dc, 0.5, obstacleGeneration, numShadowingApplied));
+
+    GIVEN("the attenuation of pathloss and obstacles applied to a first frame")
+    {
+        Signal first = makeFrame(spectrum, 0, Coord(0, 0, 2), Coord(2, 0, 2));
+        pathloss.filterSignal(&first);
+        shadowing.filterSignal(&first);
+
+        Signal uncached = makeFrame(spectrum, 0, Coord(0, 0, 2), Coord(2, 0, 2));
+        SimplePathlossModel(&dc, 2.0, false, Coord(0, 0, 0)).filterSignal(&uncached);
+
+        THEN("it is the same as without caching")
+        {
+            REQUIRE(numShadowingApplied == 1);
+            REQUIRE(pathloss.getCache().getNumMisses() == 1);
+            REQUIRE(shadowing.getCache().getNumMisses() == 1);
+            for (size_t i = 0; i < spectrum.getNumFreqs(); i++) {
+                REQUIRE(first.at(i) == Approx(uncached.at(i) * 0.5));
+            }
+        }
+
+        WHEN("a second frame arrives over the unchanged link")
+        {
+            Signal second = makeFrame(spectrum, 2, Coord(0, 0, 2), Coord(2, 0, 2));
+            pathloss.filterSignal(&second);
+            shadowing.filterSignal(&second);
+
+            THEN("pathloss and obstacle attenuation are served from the cache")
+            {
+                REQUIRE(pathloss.getCache().getNumHits() == 1);
+                REQUIRE(shadowing.getCache().getNumHits() == 1);
+                REQUIRE(numShadowingApplied == 1);
+                for (size_t i = 0; i < spectrum.getNumFreqs(); i++) {
+                    REQUIRE(second.at(i) == Approx(first.at(i)));
+                }
+                REQUIRE(second.getSendingStart() == 2);
+            }
+        }
+
+        WHEN("the obstacles changed before a second frame arrives")
+        {
+            obstacleGeneration++;
+            Signal second = makeFrame(spectrum, 2, Coord(0, 0, 2), Coord(2, 0, 2));
+            pathloss.filterSignal(&second);
+            shadowing.filterSignal(&second);
+
+            THEN("only the obstacle attenuation is computed again")
+            {
+                REQUIRE(pathloss.getCache().getNumHits() == 1);
+                REQUIRE(shadowing.getCache().getNumHits() == 0);
+                REQUIRE(numShadowingApplied == 2);
+                REQUIRE(second.at(1) == Approx(first.at(1)));
+            }
+        }
+
+        WHEN("the receiver moved before a second frame arrives")
+        {
+            Signal second = makeFrame(spectrum, 2, Coord(0, 0, 2), Coord(5, 0, 2));
+            pathloss.filterSignal(&second);
+            shadowing.filterSignal(&second);
+
+            THEN("neither attenuation is taken from the cache")
+            {
+                REQUIRE(pathloss.getCache().getNumHits() == 0);
+                REQUIRE(shadowing.getCache().getNumHits() == 0);
+                REQUIRE(second.at(1) < first.at(1));
+            }
+        }
+    }
+}
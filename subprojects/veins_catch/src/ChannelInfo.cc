@@ -0,0 +1,213 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/phyLayer/ChannelInfo.h"
+#include "testutils/Simulation.h"
+
+using namespace veins;
+
+namespace {
+
+class TestChannelInfo : public ChannelInfo {
+public:
+    using ChannelInfo::assertNoIntersections;
+
+    ~TestChannelInfo() override
+    {
+        for (auto& entry : airFrames) {
+            delete entry.frame;
+        }
+    }
+};
+
+AirFrame* makeAirFrame(simtime_t duration)
+{
+    auto frame = new AirFrame();
+    frame->setDuration(duration);
+    return frame;
+}
+
+ChannelInfo::AirFrameVector getAirFrames(const ChannelInfo& channelInfo, simtime_t from, simtime_t to)
+{
+    ChannelInfo::AirFrameVector out;
+    channelInfo.getAirFrames(from, to, out);
+    return out;
+}
+
+} // namespace
+
+SCENARIO("ChannelInfo keeps AirFrames as long as they intersect with active ones", "[channelInfo]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("AirFrames a [0, 10], b [5, 15] and c [12, 17] added chronologically")
+    {
+        TestChannelInfo channelInfo;
+        REQUIRE(channelInfo.isChannelEmpty());
+        REQUIRE(channelInfo.getEarliestInfoPoint() == -1);
+
+        AirFrame* a = makeAirFrame(10);
+        AirFrame* b = makeAirFrame(10);
+        AirFrame* c = makeAirFrame(5);
+        channelInfo.addAirFrame(a, 0);
+        channelInfo.addAirFrame(b, 5);
+        channelInfo.addAirFrame(c, 12);
+        REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+
+        THEN("AirFrames intersecting with an interval are returned sorted by start time")
+        {
+            REQUIRE(getAirFrames(channelInfo, 0, 20) == ChannelInfo::AirFrameVector{a, b, c});
+            REQUIRE(getAirFrames(channelInfo, 10, 12) == ChannelInfo::AirFrameVector{a, b, c});
+            REQUIRE(getAirFrames(channelInfo, 16, 16) == ChannelInfo::AirFrameVector{c});
+            REQUIRE(getAirFrames(channelInfo, 18, 20).empty());
+            REQUIRE(channelInfo.getEarliestInfoPoint() == 0);
+        }
+        THEN("the passed vector is appended to")
+        {
+            ChannelInfo::AirFrameVector out{c};
+            channelInfo.getAirFrames(0, 1, out);
+            REQUIRE(out == ChannelInfo::AirFrameVector{c, a});
+        }
+        WHEN("a is removed")
+        {
+            channelInfo.removeAirFrame(a, 0);
+            THEN("a is kept, as it intersects with b")
+            {
+                REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                REQUIRE(getAirFrames(channelInfo, 6, 6) == ChannelInfo::AirFrameVector{a, b});
+                REQUIRE(channelInfo.getEarliestInfoPoint() == 0);
+            }
+            AND_WHEN("b is removed")
+            {
+                channelInfo.removeAirFrame(b, 5);
+                THEN("a is discarded, but b is kept, as it intersects with c")
+                {
+                    REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                    REQUIRE(getAirFrames(channelInfo, 0, 20) == ChannelInfo::AirFrameVector{b, c});
+                    REQUIRE(channelInfo.getEarliestInfoPoint() == 5);
+                }
+                AND_WHEN("c is removed")
+                {
+                    REQUIRE(channelInfo.removeAirFrame(c, 12) == -1);
+                    THEN("the channel is empty")
+                    {
+                        REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                        REQUIRE(channelInfo.isChannelEmpty());
+                        REQUIRE(getAirFrames(channelInfo, 0, 20).empty());
+                    }
+                }
+            }
+        }
+        WHEN("c is removed first")
+        {
+            channelInfo.removeAirFrame(c, 12);
+            THEN("c is kept, as it intersects with b")
+            {
+                REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                REQUIRE(getAirFrames(channelInfo, 16, 16) == ChannelInfo::AirFrameVector{c});
+            }
+            AND_WHEN("all others are removed")
+            {
+                channelInfo.removeAirFrame(b, 5);
+                channelInfo.removeAirFrame(a, 0);
+                THEN("the channel is empty")
+                {
+                    REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                    REQUIRE(channelInfo.isChannelEmpty());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("ChannelInfo handles long and out of order AirFrames", "[channelInfo]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("a long AirFrame [0, 100] and short AirFrames [20, 21] and [10, 11], added out of order")
+    {
+        TestChannelInfo channelInfo;
+        AirFrame* longFrame = makeAirFrame(100);
+        AirFrame* late = makeAirFrame(1);
+        AirFrame* early = makeAirFrame(1);
+        channelInfo.addAirFrame(longFrame, 0);
+        channelInfo.addAirFrame(late, 20);
+        channelInfo.addAirFrame(early, 10);
+
+        THEN("AirFrames are still returned sorted by start time")
+        {
+            REQUIRE(getAirFrames(channelInfo, 0, 100) == ChannelInfo::AirFrameVector{longFrame, early, late});
+            REQUIRE(getAirFrames(channelInfo, 50, 60) == ChannelInfo::AirFrameVector{longFrame});
+        }
+        WHEN("the short AirFrames are removed")
+        {
+            channelInfo.removeAirFrame(early, 10);
+            channelInfo.removeAirFrame(late, 20);
+            THEN("they are kept, as they intersect with the long AirFrame")
+            {
+                REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                REQUIRE(getAirFrames(channelInfo, 0, 100) == ChannelInfo::AirFrameVector{longFrame, early, late});
+            }
+            AND_WHEN("the long AirFrame is removed")
+            {
+                channelInfo.removeAirFrame(longFrame, 0);
+                THEN("the channel is empty")
+                {
+                    REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                    REQUIRE(channelInfo.isChannelEmpty());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("ChannelInfo keeps AirFrames while recording", "[channelInfo]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("a recording ChannelInfo with an AirFrame [0, 5]")
+    {
+        TestChannelInfo channelInfo;
+        channelInfo.startRecording(0);
+        REQUIRE(channelInfo.isRecording());
+
+        AirFrame* a = makeAirFrame(5);
+        channelInfo.addAirFrame(a, 0);
+
+        WHEN("the AirFrame is removed")
+        {
+            channelInfo.removeAirFrame(a, 0);
+            THEN("it is kept, as it intersects with the recorded time")
+            {
+                REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                REQUIRE(getAirFrames(channelInfo, 0, 5) == ChannelInfo::AirFrameVector{a});
+            }
+            AND_WHEN("recording stops")
+            {
+                channelInfo.stopRecording();
+                THEN("the AirFrame is discarded")
+                {
+                    REQUIRE_FALSE(channelInfo.isRecording());
+                    REQUIRE_NOTHROW(channelInfo.assertNoIntersections());
+                    REQUIRE(channelInfo.isChannelEmpty());
+                }
+            }
+        }
+    }
+}
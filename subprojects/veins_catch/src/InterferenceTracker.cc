@@ -0,0 +1,150 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/phyLayer/AnalogueModel.h"
+#include "veins/base/phyLayer/InterferenceTracker.h"
+#include "veins/base/toolbox/Spectrum.h"
+#include "veins/base/toolbox/Signal.h"
+#include "veins/base/toolbox/SignalUtils.h"
+#include "veins/base/messages/AirFrame_m.h"
+#include "testutils/Simulation.h"
+
+using namespace veins;
+
+namespace {
+
+void setSignal(AirFrame& frame, const Spectrum& spectrum, AnalogueModelList& analogueModels, double power, simtime_t start, simtime_t duration)
+{
+    Signal signal(spectrum, start, duration);
+    for (size_t i = 0; i < spectrum.getNumFreqs(); i++) {
+        signal.at(i) = power;
+    }
+    signal.setDataStart(0);
+    signal.setDataEnd(spectrum.getNumFreqs() - 1);
+    signal.setAnalogueModelList(&analogueModels);
+    frame.setSignal(signal);
+}
+
+} // namespace
+
+SCENARIO("InterferenceTracker", "[phyLayer]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("A tracker with a frame (power 100, [0, 12)) watched during [1, 10)")
+    {
+        Spectrum spectrum(Spectrum::Frequencies{1, 2, 3});
+        AnalogueModelList analogueModels;
+
+        AirFrame signalFrame;
+        AirFrame interfererFrame1;
+        AirFrame interfererFrame2;
+        AirFrame interfererFrame3;
+        setSignal(signalFrame, spectrum, analogueModels, 100, 0, 12);
+        setSignal(interfererFrame1, spectrum, analogueModels, 50, 0.5, 1.5);
+        setSignal(interfererFrame2, spectrum, analogueModels, 30, 2, 2);
+        setSignal(interfererFrame3, spectrum, analogueModels, 10, 3, 10);
+
+        InterferenceTracker tracker;
+        REQUIRE(tracker.isEmpty());
+        REQUIRE(tracker.getPowerAt(0, 0) == 0);
+
+        tracker.add(&signalFrame, 0);
+        tracker.watch(&signalFrame, 0, 1, 10);
+
+        THEN("there is no interference yet")
+        {
+            REQUIRE_FALSE(tracker.isEmpty());
+            REQUIRE(tracker.getPowerAt(1, 0) == 100);
+            REQUIRE(tracker.getPowerAt(1, 0, &signalFrame) == 0);
+            REQUIRE(tracker.getMaxInterference(&signalFrame).getMax() == 0);
+        }
+        WHEN("an interferer ends before the interval starts")
+        {
+            interfererFrame1.getSignal().setTiming(0.5, 0.3);
+            tracker.add(&interfererFrame1, 0.5);
+            tracker.remove(&interfererFrame1, 0.8);
+            THEN("it does not count as interference")
+            {
+                REQUIRE(tracker.getPowerAt(1, 0.8) == 100);
+                REQUIRE(tracker.getMaxInterference(&signalFrame).getMax() == 0);
+            }
+        }
+        WHEN("an interferer overlaps with the start of the interval")
+        {
+            tracker.add(&interfererFrame1, 0.5);
+            tracker.remove(&interfererFrame1, 2);
+            THEN("it counts as interference")
+            {
+                REQUIRE(tracker.getMaxInterference(&signalFrame).getMax() == 50);
+            }
+        }
+        WHEN("interferers come and go during the interval")
+        {
+            interfererFrame1.getSignal().setTiming(11, 1);
+            tracker.add(&interfererFrame2, 2);
+            tracker.add(&interfererFrame3, 3);
+            tracker.remove(&interfererFrame2, 4);
+            tracker.add(&interfererFrame1, 11);
+            THEN("the maximum of their summed power within the interval is recorded")
+            {
+                REQUIRE(tracker.getPowerAt(0, 11) == 160);
+                REQUIRE(tracker.getPowerAt(0, 11, &signalFrame) == 60);
+                REQUIRE(tracker.getMaxInterference(&signalFrame).getMax() == 40);
+                REQUIRE(SignalUtils::getMinSINR(&signalFrame, tracker.getMaxInterference(&signalFrame), 10) == 2);
+            }
+        }
+        WHEN("an interferer ends now, but its end has not been processed yet")
+        {
+            tracker.add(&interfererFrame2, 2);
+            THEN("it only counts until it ends")
+            {
+                REQUIRE(tracker.getPowerAt(0, 3) == 130);
+                REQUIRE(tracker.getPowerAt(0, 4) == 100);
+                REQUIRE(tracker.getPowerAt(0, 4, &signalFrame) == 0);
+                REQUIRE(tracker.getPowerAt(0, 12) == 0);
+            }
+        }
+        WHEN("an interferer starts exactly when another ends, before that end has been processed")
+        {
+            interfererFrame3.getSignal().setTiming(4, 5);
+            tracker.add(&interfererFrame2, 2);
+            tracker.add(&interfererFrame3, 4);
+            tracker.remove(&interfererFrame2, 4);
+            THEN("they do not count as interfering at the same time")
+            {
+                REQUIRE(tracker.getMaxInterference(&signalFrame).getMax() == 30);
+                REQUIRE(tracker.getPowerAt(0, 4, &signalFrame) == 10);
+            }
+        }
+        WHEN("all frames are removed again")
+        {
+            tracker.add(&interfererFrame2, 2);
+            tracker.remove(&interfererFrame2, 4);
+            tracker.remove(&signalFrame, 12);
+            THEN("the channel is empty")
+            {
+                REQUIRE(tracker.isEmpty());
+                REQUIRE(tracker.getPowerAt(0, 12) == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/phyLayer/LinkBudgetCache.h"
+#include "veins/base/toolbox/Spectrum.h"
+#include "veins/base/toolbox/Signal.h"
+#include "testutils/Simulation.h"
+
+using namespace veins;
+
+namespace {
+
+Signal makeSignal(const Spectrum& spectrum, double power, simtime_t start, simtime_t duration)
+{
+    Signal signal(spectrum, start, duration);
+    signal = power;
+    return signal;
+}
+
+} // namespace
+
+SCENARIO("LinkBudgetCache", "[phyLayer]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("a link budget cached for a link")
+    {
+        Spectrum spectrum(Spectrum::Frequencies{1, 2, 3});
+        const LinkBudgetCache::Link link{Coord(0, 0), Coord(1, 0), Coord(100, 0), Coord(-1, 0)};
+
+        LinkBudgetCache cache;
+        Signal first = makeSignal(spectrum, 2, 0, 1);
+        REQUIRE_FALSE(cache.apply(1, link, first, 0));
+        Signal gain = makeSignal(spectrum, 0.25, 0, 1);
+        cache.store(1, link, gain, 0);
+        first *= gain;
+
+        WHEN("a second frame from the same sender arrives over the unchanged link")
+        {
+            Signal second = makeSignal(spectrum, 4, 2, 1);
+            const bool cached = cache.apply(1, link, second, 2);
+
+            THEN("the cached link budget is applied, regardless of the timing of the frame")
+            {
+                REQUIRE(cached);
+                REQUIRE(cache.getNumHits() == 1);
+                REQUIRE(cache.getNumMisses() == 1);
+                REQUIRE(first.at(0) == Approx(0.5));
+                for (size_t i = 0; i < spectrum.getNumFreqs(); i++) {
+                    REQUIRE(second.at(i) == Approx(1));
+                }
+                REQUIRE(second.getSendingStart() == 2);
+            }
+        }
+
+        WHEN("the sender moved")
+        {
+            LinkBudgetCache::Link moved = link;
+            moved.senderPosition = Coord(1, 0);
+            Signal second = makeSignal(spectrum, 4, 2, 1);
+
+            THEN("the link budget is not taken from the cache")
+            {
+                REQUIRE_FALSE(cache.apply(1, moved, second, 2));
+                REQUIRE(cache.getNumHits() == 0);
+                REQUIRE(second.at(0) == Approx(4));
+            }
+        }
+
+        WHEN("the obstacles changed")
+        {
+            LinkBudgetCache::Link changed = link;
+            changed.generation = 1;
+            Signal second = makeSignal(spectrum, 4, 2, 1);
+
+            THEN("the link budget is not taken from the cache")
+            {
+                REQUIRE_FALSE(cache.apply(1, changed, second, 2));
+                REQUIRE(second.at(0) == Approx(4));
+            }
+        }
+
+        WHEN("a frame from another sender arrives over the same link")
+        {
+            Signal second = makeSignal(spectrum, 4, 2, 1);
+
+            THEN("the link budget is not taken from the cache")
+            {
+                REQUIRE_FALSE(cache.apply(2, link, second, 2));
+                REQUIRE(second.at(0) == Approx(4));
+            }
+        }
+    }
+}
@@ -0,0 +1,276 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+#include "veins/base/connectionManager/NicEntry.h"
+#include "veins/base/connectionManager/NicGrid.h"
+
+using veins::Coord;
+using veins::NicEntry;
+using veins::NicGrid;
+
+namespace {
+
+class DummyNicEntry : public NicEntry {
+public:
+    DummyNicEntry(int id, const Coord& pos)
+        : NicEntry(nullptr)
+    {
+        nicId = id;
+        this->pos = pos;
+    }
+
+    void connectTo(NicEntry*) override
+    {
+    }
+
+    void disconnectFrom(NicEntry*) override
+    {
+    }
+};
+
+const double cellSize = 250;
+const double maxDistSquared = cellSize * cellSize;
+
+NicGrid::GridCoord getCell(const Coord& pos)
+{
+    return NicGrid::GridCoord(pos, Coord(cellSize, cellSize, cellSize));
+}
+
+/**
+ * Nics spread uniformly across a square scenario, along with random steps for moving them around.
+ */
+struct Scenario {
+    Scenario(size_t numNics, double size, size_t numSteps)
+        : size(size)
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> posDist(0, size);
+        std::uniform_real_distribution<double> stepDist(-20, 20);
+        for (size_t i = 0; i < numNics; ++i) {
+            nics.emplace_back(new DummyNicEntry(static_cast<int>(i), Coord(posDist(rng), posDist(rng))));
+        }
+        for (size_t i = 0; i < numNics * numSteps; ++i) {
+            steps.push_back(Coord(stepDist(rng), stepDist(rng)));
+        }
+    }
+
+    /**
+     * Move the nic with index i by the next step, staying within the scenario.
+     */
+    Coord move(size_t i, size_t& step)
+    {
+        const Coord oldPos = nics[i]->pos;
+        Coord& pos = nics[i]->pos;
+        pos.x = std::min(std::max(pos.x + steps[step].x, 0.0), size - 1);
+        pos.y = std::min(std::max(pos.y + steps[step].y, 0.0), size - 1);
+        step = (step + 1) % steps.size();
+        return oldPos;
+    }
+
+    NicGrid::GridCoord getDim() const
+    {
+        return NicGrid::GridCoord(static_cast<int>(size / cellSize) + 1, static_cast<int>(size / cellSize) + 1, 1);
+    }
+
+    double size;
+    std::vector<std::unique_ptr<DummyNicEntry>> nics;
+    std::vector<Coord> steps;
+};
+
+/**
+ * Grid as previously used by BaseConnectionManager: one map of nics per cell, neighborhoods collected in a heap-allocated set.
+ */
+class MapGrid {
+public:
+    MapGrid(const NicGrid::GridCoord& dim)
+        : dim(dim)
+        , cells(static_cast<size_t>(dim.x) * dim.y * dim.z)
+    {
+    }
+
+    size_t getIndex(const NicGrid::GridCoord& cell) const
+    {
+        return (static_cast<size_t>(cell.x) * dim.y + cell.y) * dim.z + cell.z;
+    }
+
+    void move(NicEntry* nic, const NicGrid::GridCoord& oldCell, const NicGrid::GridCoord& newCell)
+    {
+        if (oldCell == newCell) return;
+        auto& oldEntries = cells[getIndex(oldCell)];
+        oldEntries.erase(nic->nicId);
+        cells[getIndex(newCell)][nic->nicId] = nic;
+    }
+
+    std::set<size_t> getNeighborhood(const NicGrid::GridCoord& cell) const
+    {
+        std::set<size_t> neighborhood;
+        for (int x = std::max(0, cell.x - 1); x <= std::min(dim.x - 1, cell.x + 1); ++x) {
+            for (int y = std::max(0, cell.y - 1); y <= std::min(dim.y - 1, cell.y + 1); ++y) {
+                for (int z = std::max(0, cell.z - 1); z <= std::min(dim.z - 1, cell.z + 1); ++z) {
+                    neighborhood.insert(getIndex(NicGrid::GridCoord(x, y, z)));
+                }
+            }
+        }
+        return neighborhood;
+    }
+
+    NicGrid::GridCoord dim;
+    std::vector<std::map<int, NicEntry*>> cells;
+};
+
+} // namespace
+
+SCENARIO("NicGrid keeps nics in the cells of their positions", "[nicGrid]")
+{
+    GIVEN("1000 nics in a grid of 250m cells")
+    {
+        Scenario scenario(1000, 2000, 10);
+        NicGrid grid(scenario.getDim(), false);
+        for (auto& nic : scenario.nics) {
+            grid.insert(nic.get(), getCell(nic->pos));
+        }
+
+        WHEN("moving all of them around and removing every tenth")
+        {
+            size_t step = 0;
+            for (size_t round = 0; round < 50; ++round) {
+                for (size_t i = 0; i < scenario.nics.size(); ++i) {
+                    scenario.move(i, step);
+                    grid.update(scenario.nics[i].get(), getCell(scenario.nics[i]->pos));
+                }
+            }
+            for (size_t i = 0; i < scenario.nics.size(); i += 10) {
+                grid.remove(scenario.nics[i].get());
+            }
+
+            THEN("every remaining nic is stored exactly once, in the cell of its current position")
+            {
+                std::set<const NicEntry*> found;
+                const auto& dim = grid.getDim();
+                for (int x = 0; x < dim.x; ++x) {
+                    for (int y = 0; y < dim.y; ++y) {
+                        const size_t index = grid.getIndex(NicGrid::GridCoord(x, y, 0));
+                        const auto& cell = grid.getCell(index);
+                        for (size_t slot = 0; slot < cell.size(); ++slot) {
+                            const NicEntry* nic = cell[slot].nic;
+                            REQUIRE(nic->gridCell == index);
+                            REQUIRE(nic->gridSlot == slot);
+                            REQUIRE(cell[slot].pos == nic->pos);
+                            REQUIRE(getCell(nic->pos) == NicGrid::GridCoord(x, y, 0));
+                            REQUIRE(found.insert(nic).second);
+                        }
+                    }
+                }
+                REQUIRE(found.size() == scenario.nics.size() - scenario.nics.size() / 10);
+            }
+        }
+    }
+
+    GIVEN("A grid of 4x3x1 cells")
+    {
+        THEN("a corner cell has 4 neighboring cells (including itself)")
+        {
+            NicGrid grid(NicGrid::GridCoord(4, 3, 1), false);
+            NicGrid::Neighborhood neighborhood;
+            grid.addNeighborhood(neighborhood, NicGrid::GridCoord(0, 0, 0));
+            REQUIRE(neighborhood.size() == 4);
+        }
+
+        THEN("on a torus, a corner cell has 9 neighboring cells")
+        {
+            NicGrid grid(NicGrid::GridCoord(4, 3, 1), true);
+            NicGrid::Neighborhood neighborhood;
+            grid.addNeighborhood(neighborhood, NicGrid::GridCoord(0, 0, 0));
+            REQUIRE(neighborhood.size() == 9);
+
+            AND_THEN("adding the neighborhood of the opposite cell yields the whole torus, without duplicates")
+            {
+                grid.addNeighborhood(neighborhood, NicGrid::GridCoord(2, 1, 0));
+                REQUIRE(neighborhood.size() == 12);
+            }
+        }
+    }
+}
+
+TEST_CASE("NicGrid performance moving 10000 nics", "[.][nicGrid][benchmark]")
+{
+    // moves every nic once, then counts the nics in range in the neighborhood of its old and new cell (as BaseConnectionManager::checkGrid does)
+    Scenario mapGridScenario(10000, 5000, 10);
+    MapGrid mapGrid(mapGridScenario.getDim());
+    for (auto& nic : mapGridScenario.nics) {
+        mapGrid.cells[mapGrid.getIndex(getCell(nic->pos))][nic->nicId] = nic.get();
+    }
+    size_t mapGridStep = 0;
+
+    Scenario gridScenario(10000, 5000, 10);
+    NicGrid grid(gridScenario.getDim(), false);
+    for (auto& nic : gridScenario.nics) {
+        grid.insert(nic.get(), getCell(nic->pos));
+    }
+    size_t gridStep = 0;
+
+    BENCHMARK("std::map per cell")
+    {
+        size_t numInRange = 0;
+        for (size_t i = 0; i < mapGridScenario.nics.size(); ++i) {
+            NicEntry* nic = mapGridScenario.nics[i].get();
+            const auto oldCell = getCell(mapGridScenario.move(i, mapGridStep));
+            const auto newCell = getCell(nic->pos);
+            mapGrid.move(nic, oldCell, newCell);
+            auto neighborhood = mapGrid.getNeighborhood(oldCell);
+            auto newNeighborhood = mapGrid.getNeighborhood(newCell);
+            neighborhood.insert(newNeighborhood.begin(), newNeighborhood.end());
+            for (size_t c : neighborhood) {
+                for (auto& entry : mapGrid.cells[c]) {
+                    if (entry.second != nic && entry.second->pos.sqrdist(nic->pos) <= maxDistSquared) ++numInRange;
+                }
+            }
+        }
+        return numInRange;
+    };
+
+    BENCHMARK("NicGrid")
+    {
+        size_t numInRange = 0;
+        for (size_t i = 0; i < gridScenario.nics.size(); ++i) {
+            NicEntry* nic = gridScenario.nics[i].get();
+            const auto oldCell = getCell(gridScenario.move(i, gridStep));
+            const auto newCell = getCell(nic->pos);
+            grid.update(nic, newCell);
+            NicGrid::Neighborhood neighborhood;
+            grid.addNeighborhood(neighborhood, oldCell);
+            grid.addNeighborhood(neighborhood, newCell);
+            for (size_t c : neighborhood) {
+                for (auto& slot : grid.getCell(c)) {
+                    if (slot.nic != nic && slot.pos.sqrdist(nic->pos) <= maxDistSquared) ++numInRange;
+                }
+            }
+        }
+        return numInRange;
+    };
+}
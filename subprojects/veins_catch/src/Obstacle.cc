@@ -0,0 +1,128 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/obstacle/Obstacle.h"
+
+using veins::Coord;
+using veins::Obstacle;
+
+SCENARIO("Obstacle", "[obstacle]")
+{
+    GIVEN("A square building from (10,-10) to (30,10)")
+    {
+        Obstacle o("building#0", "building", 9, 0.4);
+        o.setShape({Coord(10, -10), Coord(30, -10), Coord(30, 10), Coord(10, 10)});
+
+        WHEN("it has no height")
+        {
+            THEN("a transmission along the x axis crosses both walls, no matter how high")
+            {
+                auto i = o.getIntersections(Coord(0, 0, 100), Coord(40, 0, 100));
+                REQUIRE(i.size() == 2);
+                REQUIRE(i[0] == Approx(0.25));
+                REQUIRE(i[1] == Approx(0.75));
+            }
+        }
+
+        WHEN("it is 20m high")
+        {
+            o.setHeight(20);
+
+            THEN("its bounding box reaches from z=0 to z=20")
+            {
+                REQUIRE(o.getBboxP1().z == 0);
+                REQUIRE(o.getBboxP2().z == 20);
+            }
+
+            THEN("a transmission below its roof crosses both walls")
+            {
+                auto i = o.getIntersections(Coord(0, 0, 5), Coord(40, 0, 5));
+                REQUIRE(i.size() == 2);
+                REQUIRE(i[0] == Approx(0.25));
+                REQUIRE(i[1] == Approx(0.75));
+            }
+
+            THEN("a transmission above its roof crosses nothing")
+            {
+                REQUIRE(o.getIntersections(Coord(0, 0, 25), Coord(40, 0, 25)).empty());
+            }
+
+            THEN("a transmission climbing over it enters through a wall and leaves through the roof")
+            {
+                // z = 40 * fraction, reaching the roof at fraction 0.5
+                auto i = o.getIntersections(Coord(0, 0, 0), Coord(40, 0, 40));
+                REQUIRE(i.size() == 2);
+                REQUIRE(i[0] == Approx(0.25));
+                REQUIRE(i[1] == Approx(0.5));
+            }
+
+            THEN("the crossings of a transmission climbing over it count both cuts and the part inside")
+            {
+                size_t numCuts;
+                double fractionInObstacle;
+                REQUIRE(o.getCrossings(Coord(0, 0, 0), Coord(40, 0, 40), numCuts, fractionInObstacle));
+                REQUIRE(numCuts == 2);
+                REQUIRE(fractionInObstacle == Approx(0.25));
+            }
+
+            THEN("the crossings of a transmission starting inside count one cut and the part inside")
+            {
+                size_t numCuts;
+                double fractionInObstacle;
+                REQUIRE(o.getCrossings(Coord(20, 0, 5), Coord(40, 0, 5), numCuts, fractionInObstacle));
+                REQUIRE(numCuts == 1);
+                REQUIRE(fractionInObstacle == Approx(0.5));
+            }
+
+            THEN("a transmission above its roof has no crossings")
+            {
+                size_t numCuts;
+                double fractionInObstacle;
+                REQUIRE(!o.getCrossings(Coord(0, 0, 25), Coord(40, 0, 25), numCuts, fractionInObstacle));
+            }
+
+            THEN("a point on its roof is not inside, a point below is")
+            {
+                REQUIRE(!o.containsPoint(Coord(20, 0, 25)));
+                REQUIRE(o.containsPoint(Coord(20, 0, 15)));
+            }
+        }
+
+        WHEN("it floats from z=10 to z=20")
+        {
+            o.setHeight(10, 10);
+
+            THEN("a transmission below it crosses nothing")
+            {
+                REQUIRE(o.getIntersections(Coord(0, 0, 5), Coord(40, 0, 5)).empty());
+            }
+
+            THEN("a transmission from below to above enters through its floor and leaves through its roof")
+            {
+                auto i = o.getIntersections(Coord(20, 0, 0), Coord(21, 0, 40));
+                REQUIRE(i.size() == 2);
+                REQUIRE(i[0] == Approx(0.25));
+                REQUIRE(i[1] == Approx(0.5));
+            }
+        }
+    }
+}
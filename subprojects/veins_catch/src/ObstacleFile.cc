@@ -0,0 +1,236 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "veins/modules/obstacle/ObstacleFile.h"
+#include "testutils/Simulation.h"
+
+using veins::ObstacleFile;
+
+namespace {
+
+/**
+ * Records of an obstacle file, written the same way as bin/veins_convert_obstacles does.
+ */
+struct ObstacleFileContents {
+    std::vector<ObstacleFile::Type> types;
+    std::vector<ObstacleFile::Entry> entries;
+    std::vector<ObstacleFile::Vertex> vertices;
+    std::string strings;
+
+    void addType(const std::string& id, double attenuationPerCut, double attenuationPerMeter)
+    {
+        types.push_back({strings.size(), id.size(), attenuationPerCut, attenuationPerMeter});
+        strings += id;
+    }
+
+    void addObstacle(const std::string& id, uint64_t typeIndex, const std::vector<ObstacleFile::Vertex>& shape, double base, double top)
+    {
+        ObstacleFile::Entry entry{strings.size(), id.size(), typeIndex, vertices.size(), shape.size(), 1e7, 1e7, -1e7, -1e7, base, top};
+        for (const auto& v : shape) {
+            entry.minX = std::min(entry.minX, v.x);
+            entry.minY = std::min(entry.minY, v.y);
+            entry.maxX = std::max(entry.maxX, v.x);
+            entry.maxY = std::max(entry.maxY, v.y);
+        }
+        entries.push_back(entry);
+        vertices.insert(vertices.end(), shape.begin(), shape.end());
+        strings += id;
+    }
+
+    std::vector<char> toBytes() const
+    {
+        ObstacleFile::Header header{};
+        std::memcpy(header.magic, ObstacleFile::magic, sizeof(header.magic));
+        header.byteOrderMark = ObstacleFile::byteOrderMark;
+        header.version = ObstacleFile::version;
+        header.numTypes = types.size();
+        header.numObstacles = entries.size();
+        header.numVertices = vertices.size();
+        header.stringsSize = strings.size();
+
+        std::vector<char> bytes;
+        auto append = [&bytes](const void* data, size_t size) {
+            const char* begin = static_cast<const char*>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        };
+        append(&header, sizeof(header));
+        append(types.data(), types.size() * sizeof(ObstacleFile::Type));
+        append(entries.data(), entries.size() * sizeof(ObstacleFile::Entry));
+        append(vertices.data(), vertices.size() * sizeof(ObstacleFile::Vertex));
+        append(strings.data(), strings.size());
+        return bytes;
+    }
+};
+
+/**
+ * A file in the working directory holding the passed bytes, deleted when going out of scope.
+ */
+class TemporaryFile {
+public:
+    explicit TemporaryFile(const std::vector<char>& bytes)
+        : name("veins_catch_ObstacleFile.tmp")
+    {
+        std::ofstream file(name, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), bytes.size());
+    }
+    ~TemporaryFile()
+    {
+        std::remove(name.c_str());
+    }
+    const std::string& getName() const
+    {
+        return name;
+    }
+
+private:
+    std::string name;
+};
+
+} // namespace
+
+SCENARIO("ObstacleFile", "[obstacle]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("a file with an obstacle type, an extruded obstacle, and an obstacle without height")
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        ObstacleFileContents contents;
+        contents.addType("building", 9, 0.4);
+        contents.addObstacle("building#0", 0, {{16, 0}, {8, 13.8564}, {-8, 13.8564}}, 0, 20);
+        contents.addObstacle("building#1", 0, {{0, 0}, {10, 0}, {10, 10}, {0, 10}}, -inf, inf);
+
+        WHEN("it is read")
+        {
+            TemporaryFile file(contents.toBytes());
+            ObstacleFile obstacleFile(file.getName());
+            const ObstacleFile::Header& header = obstacleFile.getHeader();
+
+            THEN("all records are read back unchanged")
+            {
+                REQUIRE(header.numTypes == 1);
+                REQUIRE(header.numObstacles == 2);
+                REQUIRE(header.numVertices == 7);
+
+                const ObstacleFile::Type& type = obstacleFile.getType(0);
+                REQUIRE(obstacleFile.getString(type.idOffset, type.idLength) == "building");
+                REQUIRE(type.attenuationPerCut == 9);
+                REQUIRE(type.attenuationPerMeter == 0.4);
+
+                const ObstacleFile::Entry& first = obstacleFile.getEntry(0);
+                REQUIRE(obstacleFile.getString(first.idOffset, first.idLength) == "building#0");
+                REQUIRE(first.typeIndex == 0);
+                REQUIRE(first.numVertices == 3);
+                REQUIRE(obstacleFile.getVertices(first)[1].x == 8);
+                REQUIRE(obstacleFile.getVertices(first)[1].y == 13.8564);
+                REQUIRE(first.minX == -8);
+                REQUIRE(first.maxY == 13.8564);
+                REQUIRE(first.base == 0);
+                REQUIRE(first.top == 20);
+
+                const ObstacleFile::Entry& second = obstacleFile.getEntry(1);
+                REQUIRE(obstacleFile.getString(second.idOffset, second.idLength) == "building#1");
+                REQUIRE(second.numVertices == 4);
+                REQUIRE(obstacleFile.getVertices(second)[2].x == 10);
+                REQUIRE(obstacleFile.getVertices(second)[2].y == 10);
+                REQUIRE(second.base == -inf);
+                REQUIRE(second.top == inf);
+            }
+        }
+
+        WHEN("the file is truncated")
+        {
+            std::vector<char> bytes = contents.toBytes();
+            bytes.pop_back();
+            TemporaryFile file(bytes);
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+
+        WHEN("the file is cut off within the header")
+        {
+            std::vector<char> bytes = contents.toBytes();
+            bytes.resize(sizeof(ObstacleFile::Header) - 1);
+            TemporaryFile file(bytes);
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+
+        WHEN("the file does not start with the magic number")
+        {
+            std::vector<char> bytes = contents.toBytes();
+            bytes[0] = 'X';
+            TemporaryFile file(bytes);
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+
+        WHEN("an obstacle refers to a type that does not exist")
+        {
+            contents.entries[1].typeIndex = 1;
+            TemporaryFile file(contents.toBytes());
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+
+        WHEN("an obstacle refers to vertices beyond the end of the vertices")
+        {
+            contents.entries[1].numVertices = 5;
+            TemporaryFile file(contents.toBytes());
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+
+        WHEN("an obstacle's id lies beyond the end of the strings")
+        {
+            contents.entries[0].idOffset = contents.strings.size();
+            TemporaryFile file(contents.toBytes());
+
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(ObstacleFile(file.getName()), cRuntimeError);
+            }
+        }
+    }
+}
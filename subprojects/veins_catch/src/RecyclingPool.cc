@@ -0,0 +1,89 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <vector>
+
+#include "veins/base/utils/RecyclingPool.h"
+
+using veins::RecyclingAllocator;
+using veins::RecyclingPool;
+
+namespace {
+
+struct PoolOwner {
+};
+
+struct AllocatorOwner {
+};
+
+} // namespace
+
+SCENARIO("RecyclingPool reuses freed blocks", "[recyclingPool]")
+{
+    RecyclingPool& pool = RecyclingPool::get<PoolOwner>();
+
+    GIVEN("A block of 64 bytes that was freed")
+    {
+        void* block = pool.allocate(64);
+        pool.deallocate(block, 64);
+        pool.resetCounters();
+
+        THEN("the pool is named after its owner")
+        {
+            REQUIRE(pool.getName() == "PoolOwner");
+        }
+
+        THEN("allocating 64 bytes again returns the same block")
+        {
+            REQUIRE(pool.allocate(64) == block);
+            REQUIRE(pool.getNumAllocations() == 1);
+            REQUIRE(pool.getNumReuses() == 1);
+            pool.deallocate(block, 64);
+        }
+
+        THEN("allocating 128 bytes does not reuse it")
+        {
+            void* other = pool.allocate(128);
+            REQUIRE(other != block);
+            REQUIRE(pool.getNumReuses() == 0);
+            pool.deallocate(other, 128);
+        }
+    }
+
+    GIVEN("A vector using a RecyclingAllocator that was destroyed")
+    {
+        RecyclingPool& vectorPool = RecyclingPool::get<AllocatorOwner>();
+        const double* data;
+        {
+            std::vector<double, RecyclingAllocator<double, AllocatorOwner>> values(10, 1.0);
+            data = values.data();
+        }
+        vectorPool.resetCounters();
+
+        THEN("a new vector of the same size reuses its memory")
+        {
+            std::vector<double, RecyclingAllocator<double, AllocatorOwner>> values(10, 2.0);
+            REQUIRE(values.data() == data);
+            REQUIRE(vectorPool.getNumReuses() == 1);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <random>
+#include <vector>
+
+#include "veins/base/toolbox/Spectrum.h"
+#include "veins/base/toolbox/Signal.h"
+#include "veins/base/toolbox/SignalExpression.h"
+#include "testutils/Simulation.h"
+
+using namespace veins;
+
+namespace {
+
+/**
+ * Signals with random values on a spectrum of numFreqs frequencies, all of which are in the data range.
+ */
+std::vector<Signal> makeSignals(size_t numFreqs, size_t numSignals)
+{
+    Spectrum::Frequencies freqs;
+    for (size_t i = 0; i < numFreqs; ++i) {
+        freqs.push_back(5.85e9 + i * 5e6);
+    }
+    Spectrum spectrum(freqs);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> powerDist(1e-12, 1e-3);
+    std::vector<Signal> signals;
+    for (size_t s = 0; s < numSignals; ++s) {
+        Signal signal(spectrum);
+        signal.setDataNumValues(numFreqs);
+        for (size_t i = 0; i < numFreqs; ++i) {
+            signal.at(i) = powerDist(rng);
+        }
+        signals.push_back(signal);
+    }
+    return signals;
+}
+
+void benchmarkArithmetic(size_t numFreqs)
+{
+    // as many signals as needed for roughly the same number of values per benchmark run
+    const size_t numSignals = std::max<size_t>(16, 16384 / numFreqs);
+    auto signals = makeSignals(numFreqs, numSignals);
+    const Signal noise = makeSignals(numFreqs, 1).front();
+
+    BENCHMARK("gain (Signal *= double)")
+    {
+        for (auto& signal : signals) {
+            signal *= 0.5;
+            signal *= 2;
+        }
+        return signals.front().at(0);
+    };
+
+    BENCHMARK("interference sum (Signal += Signal)")
+    {
+        Signal interference = noise;
+        for (const auto& signal : signals) {
+            interference += signal;
+        }
+        return interference.at(0);
+    };
+
+    BENCHMARK("minimum SINR (Signal / (Signal + Signal))")
+    {
+        double sum = 0;
+        for (size_t i = 1; i < signals.size(); ++i) {
+            sum += (signals[i] / (signals[i - 1] + noise)).getDataMin();
+        }
+        return sum;
+    };
+
+    BENCHMARK("minimum SINR (lazily evaluated)")
+    {
+        double sum = 0;
+        for (size_t i = 1; i < signals.size(); ++i) {
+            sum += (lazy(signals[i]) / (lazy(signals[i - 1]) + noise)).getDataMin();
+        }
+        return sum;
+    };
+}
+
+} // namespace
+
+SCENARIO("Lazily evaluated Signal expressions", "[toolbox]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("Three signals with random values")
+    {
+        auto signals = makeSignals(15, 3);
+        const Signal& a = signals[0];
+        const Signal& b = signals[1];
+        const Signal& c = signals[2];
+
+        THEN("evaluating an expression yields the same values as the eager operators")
+        {
+            Signal eager = a / (b + 2.0) - 3 * c;
+            Signal fused = lazy(a) / (lazy(b) + 2.0) - 3 * lazy(c);
+            REQUIRE(fused.getSpectrum() == eager.getSpectrum());
+            for (size_t i = 0; i < eager.getNumValues(); ++i) {
+                REQUIRE(fused.at(i) == eager.at(i));
+            }
+        }
+
+        WHEN("restricting the data range")
+        {
+            signals[0].setDataStart(5);
+            signals[0].setDataEnd(10);
+
+            THEN("reductions over the data range of the leftmost signal match those of the computed signal")
+            {
+                Signal eager = a / (b + c);
+                REQUIRE((lazy(a) / (lazy(b) + c)).getDataMin() == eager.getDataMin());
+                REQUIRE((lazy(a) / (lazy(b) + c)).getDataMax() == eager.getDataMax());
+                REQUIRE((lazy(a) / (lazy(b) + c)).getMax() == eager.getMax());
+            }
+        }
+    }
+}
+
+TEST_CASE("Signal arithmetic performance on the IEEE 802.11p spectrum (15 frequencies)", "[.][toolbox][benchmark]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    benchmarkArithmetic(15);
+}
+
+TEST_CASE("Signal arithmetic performance on a wideband spectrum (1024 frequencies)", "[.][toolbox][benchmark]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    benchmarkArithmetic(1024);
+}
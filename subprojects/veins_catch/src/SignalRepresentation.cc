@@ -106,6 +106,16 @@ SCENARIO("Spectrum", "[toolbox]")
                     REQUIRE(spectrum == spectrumClone);
                 }
             }
+            WHEN("another spectrum is created with one frequency missing")
+            {
+                auto fewerFreqs = freqs;
+                fewerFreqs.erase(std::remove(fewerFreqs.begin(), fewerFreqs.end(), 6), fewerFreqs.end());
+                Spectrum other(fewerFreqs);
+                THEN("the spectra are not equal")
+                {
+                    REQUIRE(!(spectrum == other));
+                }
+            }
         }
     }
 }
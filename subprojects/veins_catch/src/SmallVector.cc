@@ -0,0 +1,187 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <utility>
+#include <vector>
+
+#include "veins/base/utils/SmallVector.h"
+
+using veins::SmallVector;
+
+namespace {
+
+using Values = SmallVector<double, 4>;
+
+/** Returns 0, 1, ..., count - 1 (offset by start), so elements copied from the wrong place are noticed. */
+Values makeValues(size_t count, double start = 0)
+{
+    Values values(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = start + i;
+    }
+    return values;
+}
+
+std::vector<double> toVector(const Values& values)
+{
+    return std::vector<double>(values.begin(), values.end());
+}
+
+std::vector<double> expectedValues(size_t count, double start = 0)
+{
+    std::vector<double> expected;
+    for (size_t i = 0; i < count; ++i) {
+        expected.push_back(start + i);
+    }
+    return expected;
+}
+
+} // namespace
+
+SCENARIO("SmallVector stores small sizes inline and larger ones on the heap", "[smallVector]")
+{
+    GIVEN("a vector of 4 values")
+    {
+        Values small = makeValues(4);
+
+        THEN("its values are stored inline")
+        {
+            REQUIRE(small.isInline());
+            REQUIRE(small.data() != nullptr);
+            REQUIRE(toVector(small) == expectedValues(4));
+        }
+
+        WHEN("a vector of 5 values is copy assigned to it")
+        {
+            const Values large = makeValues(5, 10);
+            small = large;
+
+            THEN("it holds a copy on the heap, and the original is unchanged")
+            {
+                REQUIRE_FALSE(small.isInline());
+                REQUIRE(toVector(small) == expectedValues(5, 10));
+                REQUIRE(small.data() != large.data());
+                REQUIRE(toVector(large) == expectedValues(5, 10));
+            }
+        }
+
+        WHEN("a vector of 5 values is move assigned to it")
+        {
+            Values large = makeValues(5, 10);
+            const double* heapData = large.data();
+            small = std::move(large);
+
+            THEN("it takes over the heap memory, and the original is empty")
+            {
+                REQUIRE_FALSE(small.isInline());
+                REQUIRE(small.data() == heapData);
+                REQUIRE(toVector(small) == expectedValues(5, 10));
+                REQUIRE(large.size() == 0);
+            }
+        }
+
+        WHEN("5 values are assigned to it")
+        {
+            small.assign(5, 7);
+
+            THEN("they are stored on the heap")
+            {
+                REQUIRE_FALSE(small.isInline());
+                REQUIRE(toVector(small) == std::vector<double>(5, 7));
+            }
+        }
+    }
+
+    GIVEN("a vector of 5 values")
+    {
+        Values large = makeValues(5);
+
+        THEN("its values are stored on the heap")
+        {
+            REQUIRE_FALSE(large.isInline());
+            REQUIRE(toVector(large) == expectedValues(5));
+        }
+
+        WHEN("a vector of 4 values is copy assigned to it")
+        {
+            const Values small = makeValues(4, 10);
+            large = small;
+
+            THEN("it holds a copy inline, and the original is unchanged")
+            {
+                REQUIRE(large.isInline());
+                REQUIRE(toVector(large) == expectedValues(4, 10));
+                REQUIRE(large.data() != small.data());
+                REQUIRE(toVector(small) == expectedValues(4, 10));
+            }
+        }
+
+        WHEN("a vector of 4 values is move assigned to it")
+        {
+            Values small = makeValues(4, 10);
+            large = std::move(small);
+
+            THEN("it holds the values inline, and the original is empty")
+            {
+                REQUIRE(large.isInline());
+                REQUIRE(toVector(large) == expectedValues(4, 10));
+                REQUIRE(small.size() == 0);
+            }
+        }
+
+        WHEN("4 values are assigned to it")
+        {
+            large.assign(4, 7);
+
+            THEN("they are stored inline")
+            {
+                REQUIRE(large.isInline());
+                REQUIRE(toVector(large) == std::vector<double>(4, 7));
+            }
+
+            AND_WHEN("6 values are assigned to it again")
+            {
+                large.assign(6, 8);
+
+                THEN("they are stored on the heap again")
+                {
+                    REQUIRE_FALSE(large.isInline());
+                    REQUIRE(toVector(large) == std::vector<double>(6, 8));
+                }
+            }
+        }
+
+        WHEN("it is copy constructed")
+        {
+            Values copy(large);
+            copy[0] = 42;
+
+            THEN("the copy is independent of the original")
+            {
+                REQUIRE(copy.size() == 5);
+                REQUIRE(copy.at(0) == 42);
+                REQUIRE(large.at(0) == 0);
+                REQUIRE_THROWS_AS(copy.at(5), std::out_of_range);
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "veins/base/utils/WorkerPool.h"
+
+using veins::WorkerPool;
+
+SCENARIO("WorkerPool", "[workerPool]")
+{
+    GIVEN("a pool of 4 threads")
+    {
+        WorkerPool pool(4);
+        REQUIRE(pool.getNumThreads() == 4);
+
+        WHEN("tasks process shared work items repeatedly")
+        {
+            const size_t numItems = 1000;
+            std::vector<int> processed(numItems);
+            for (int round = 0; round < 50; ++round) {
+                std::atomic<size_t> nextItem(0);
+                pool.run([&processed, &nextItem, numItems]() {
+                    for (size_t i = nextItem++; i < numItems; i = nextItem++) {
+                        ++processed[i];
+                    }
+                },
+                    4);
+            }
+
+            THEN("every item is processed once per round")
+            {
+                for (size_t i = 0; i < numItems; ++i) {
+                    REQUIRE(processed[i] == 50);
+                }
+            }
+        }
+
+        WHEN("a task is run on at most 2 threads")
+        {
+            std::atomic<int> numCalls(0);
+            pool.run([&numCalls]() { ++numCalls; }, 2);
+
+            THEN("it runs on the calling thread and one pooled thread")
+            {
+                REQUIRE(numCalls == 2);
+            }
+        }
+
+        WHEN("a task is run on at most 1 thread")
+        {
+            std::thread::id caller;
+            pool.run([&caller]() { caller = std::this_thread::get_id(); }, 1);
+
+            THEN("it only runs on the calling thread")
+            {
+                REQUIRE(caller == std::this_thread::get_id());
+            }
+        }
+
+        WHEN("a task is run on more threads than the pool has")
+        {
+            std::atomic<int> numCalls(0);
+            pool.run([&numCalls]() { ++numCalls; }, 8);
+
+            THEN("it runs once on every thread of the pool")
+            {
+                REQUIRE(numCalls == 4);
+            }
+        }
+    }
+}